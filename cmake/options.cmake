@@ -13,6 +13,7 @@ option(BUILD_GIT_ID                         "Build git_id"
 option(BUILD_DOCS                           "Build documentation with doxygen"          OFF)
 option(CMAKE_INTERPROCEDURAL_OPTIMIZATION   "Enable link-time optimizations"            OFF)
 option(BUILD_DEPRECATED_PLAYERBOT           "Build previous version of Playerbot mod"   OFF)
+option(BUILD_BENCHMARKS                     "Build core container microbenchmarks"      OFF)
 set(DEV_BINARY_DIR ${CMAKE_BINARY_DIR} CACHE STRING "Executable directory on Windows")
 
 # TODO: options that should be checked/created:
@@ -40,6 +41,7 @@ message(STATUS
     BUILD_DOCS              Build documentation with doxygen
     CMAKE_INTERPROCEDURAL_OPTIMIZATION Enable link-time optimizations
     BUILD_DEPRECATED_PLAYERBOT         Build Playerbot mod (deprecated)
+    BUILD_BENCHMARKS        Build core container microbenchmarks
     BUILD_SCRIPTDEV         Build scriptdev. (Disable it to speedup build
                                 in dev mode by not including scripts)
 
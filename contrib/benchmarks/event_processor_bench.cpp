@@ -0,0 +1,229 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+// Compares EventProcessor with the multimap based queue it replaced on a workload shaped like
+// creature updates: a few periodic events per object plus an AI notify rescheduled on relocation.
+// Usage: bench_eventprocessor [objects] [ticks]
+
+#include "Utilities/EventProcessor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // the previous EventProcessor, kept here as the baseline
+    class MultimapEventProcessor
+    {
+        public:
+            ~MultimapEventProcessor()
+            {
+                for (auto& event : m_events)
+                    delete event.second;
+            }
+
+            void Update(uint32 p_time)
+            {
+                m_time += p_time;
+
+                std::multimap<uint64, BasicEvent*>::iterator i;
+                while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+                {
+                    BasicEvent* event = i->second;
+                    m_events.erase(i);
+
+                    if (event->Execute(m_time, p_time))
+                        delete event;
+                }
+            }
+
+            void KillEvent(BasicEvent* event)
+            {
+                for (auto iter = m_events.begin(); iter != m_events.end();)
+                {
+                    if (iter->second == event)
+                    {
+                        delete iter->second;
+                        iter = m_events.erase(iter);
+                    }
+                    else
+                        ++iter;
+                }
+            }
+
+            void AddEvent(BasicEvent* event, uint64 e_time)
+            {
+                event->m_addTime = m_time;
+                event->m_execTime = e_time;
+                m_events.insert(std::pair<uint64, BasicEvent*>(e_time, event));
+            }
+
+            uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
+
+        private:
+            uint64 m_time = 0;
+            std::multimap<uint64, BasicEvent*> m_events;
+    };
+
+    template<class Processor>
+    struct BenchObject
+    {
+        Processor events;
+        BasicEvent* notifyEvent = nullptr;
+        uint64 executed = 0;
+    };
+
+    // re-adds itself like spell, aura and script timers do
+    template<class Processor>
+    class PeriodicEvent : public BasicEvent
+    {
+        public:
+            PeriodicEvent(BenchObject<Processor>& owner, uint32 period) : m_owner(owner), m_period(period) {}
+
+            bool Execute(uint64 e_time, uint32 /*p_time*/) override
+            {
+                ++m_owner.executed;
+                m_owner.events.AddEvent(this, e_time + m_period);
+                return false;
+            }
+
+        private:
+            BenchObject<Processor>& m_owner;
+            uint32 m_period;
+    };
+
+    // same shape as UnitVisitObjectsInRangeNotifyEvent, pooled as it is now
+    class FlatNotifyEvent : public PooledEvent<FlatNotifyEvent>
+    {
+        public:
+            explicit FlatNotifyEvent(BenchObject<EventProcessor>& owner) : m_owner(owner) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                ++m_owner.executed;
+                m_owner.notifyEvent = nullptr;
+                return true;
+            }
+
+        private:
+            BenchObject<EventProcessor>& m_owner;
+    };
+
+    class MultimapNotifyEvent : public BasicEvent
+    {
+        public:
+            explicit MultimapNotifyEvent(BenchObject<MultimapEventProcessor>& owner) : m_owner(owner) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                ++m_owner.executed;
+                m_owner.notifyEvent = nullptr;
+                return true;
+            }
+
+        private:
+            BenchObject<MultimapEventProcessor>& m_owner;
+    };
+
+    // as Unit::ScheduleAINotify before and after the change
+    void ScheduleNotify(BenchObject<EventProcessor>& object, uint32 delay)
+    {
+        if (!object.notifyEvent)
+        {
+            object.notifyEvent = new FlatNotifyEvent(object);
+            object.events.AddEvent(object.notifyEvent, object.events.CalculateTime(delay));
+        }
+        else
+            object.events.ModifyEventTime(object.notifyEvent, object.events.CalculateTime(delay));
+    }
+
+    void ScheduleNotify(BenchObject<MultimapEventProcessor>& object, uint32 delay)
+    {
+        if (object.notifyEvent)
+            object.events.KillEvent(object.notifyEvent);
+
+        object.notifyEvent = new MultimapNotifyEvent(object);
+        object.events.AddEvent(object.notifyEvent, object.events.CalculateTime(delay));
+    }
+
+    template<class Processor>
+    uint64 Run(char const* name, uint32 objectCount, uint32 ticks)
+    {
+        std::mt19937 rng(12345);                            // same workload for every implementation
+        std::uniform_int_distribution<uint32> period(200, 5000);
+        std::uniform_int_distribution<uint32> percent(0, 99);
+
+        std::vector<std::unique_ptr<BenchObject<Processor>>> objects(objectCount);
+        for (auto& object : objects)
+        {
+            object.reset(new BenchObject<Processor>());
+            for (uint32 i = 0; i < 3; ++i)
+            {
+                uint32 eventPeriod = period(rng);
+                object->events.AddEvent(new PeriodicEvent<Processor>(*object, eventPeriod), object->events.CalculateTime(eventPeriod));
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 tick = 0; tick < ticks; ++tick)
+        {
+            for (auto& object : objects)
+            {
+                // moving creatures reschedule their notify on most ticks
+                if (percent(rng) < 40)
+                    ScheduleNotify(*object, 1000);
+
+                object->events.Update(50);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        uint64 executed = 0;
+        for (auto& object : objects)
+            executed += object->executed;
+
+        std::printf("%-10s %8.1f ms  %llu events executed\n", name,
+                    std::chrono::duration<double, std::milli>(end - start).count(), (unsigned long long)executed);
+        return executed;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 objectCount = argc > 1 ? uint32(std::atoi(argv[1])) : 20000;
+    uint32 ticks = argc > 2 ? uint32(std::atoi(argv[2])) : 200;
+
+    std::printf("%u objects, %u ticks of 50 ms\n", objectCount, ticks);
+
+    uint64 multimapExecuted = Run<MultimapEventProcessor>("multimap", objectCount, ticks);
+    uint64 flatExecuted = Run<EventProcessor>("flat", objectCount, ticks);
+
+    if (multimapExecuted != flatExecuted)
+    {
+        std::printf("executed event counts differ\n");
+        return 1;
+    }
+
+    return 0;
+}
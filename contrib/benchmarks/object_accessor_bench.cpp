@@ -0,0 +1,167 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+// Contention benchmark of HashMapHolder, the storage behind ObjectAccessor::FindPlayer.
+// N threads stand in for map update threads looking up random players while one thread
+// keeps logging players out and in, against the single mutex holder it replaced.
+// Usage: bench_objectaccessor [players] [lookups per thread]
+
+#include "Globals/HashMapHolder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct BenchPlayer
+    {
+        explicit BenchPlayer(uint32 counter) : guid(HIGHGUID_PLAYER, counter) {}
+        ObjectGuid GetObjectGuid() const { return guid; }
+        ObjectGuid guid;
+    };
+
+    // the previous holder, one map behind one mutex for readers and writers
+    class SingleLockHolder
+    {
+        public:
+            static void Insert(BenchPlayer* o)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_objectMap[o->GetObjectGuid()] = o;
+            }
+
+            static void Remove(BenchPlayer* o)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_objectMap.erase(o->GetObjectGuid());
+            }
+
+            static BenchPlayer* Find(ObjectGuid guid)
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                auto itr = m_objectMap.find(guid);
+                return (itr != m_objectMap.end()) ? itr->second : nullptr;
+            }
+
+        private:
+            static std::mutex m_lock;
+            static std::unordered_map<ObjectGuid, BenchPlayer*> m_objectMap;
+    };
+
+    std::mutex SingleLockHolder::m_lock;
+    std::unordered_map<ObjectGuid, BenchPlayer*> SingleLockHolder::m_objectMap;
+
+    typedef HashMapHolder<BenchPlayer> ShardedHolder;
+
+    // returns lookups per millisecond, wrongLookups counts results belonging to another guid
+    template<class Holder>
+    double Run(std::vector<BenchPlayer>& players, uint32 threadCount, uint32 lookups, uint32& wrongLookups)
+    {
+        for (BenchPlayer& player : players)
+            Holder::Insert(&player);
+
+        std::atomic<bool> stop(false);
+        std::atomic<uint32> wrong(0);
+
+        // logins and logouts, far rarer than lookups
+        std::thread writer([&]()
+        {
+            std::mt19937 rng(7);
+            std::uniform_int_distribution<uint32> pick(0, uint32(players.size()) - 1);
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                BenchPlayer& player = players[pick(rng)];
+                Holder::Remove(&player);
+                Holder::Insert(&player);
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> readers;
+        for (uint32 t = 0; t < threadCount; ++t)
+        {
+            readers.emplace_back([&, t]()
+            {
+                std::mt19937 rng(t + 1);
+                std::uniform_int_distribution<uint32> pick(1, uint32(players.size()));
+                uint32 localWrong = 0;
+                for (uint32 i = 0; i < lookups; ++i)
+                {
+                    ObjectGuid guid(HIGHGUID_PLAYER, pick(rng));
+                    if (BenchPlayer* player = Holder::Find(guid))
+                        if (player->GetObjectGuid() != guid)
+                            ++localWrong;
+                }
+                wrong += localWrong;
+            });
+        }
+
+        for (std::thread& reader : readers)
+            reader.join();
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        stop = true;
+        writer.join();
+
+        for (BenchPlayer& player : players)
+            Holder::Remove(&player);
+
+        wrongLookups += wrong;
+        return double(threadCount) * lookups / elapsed;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 playerCount = argc > 1 ? uint32(std::atoi(argv[1])) : 5000;
+    uint32 lookups = argc > 2 ? uint32(std::atoi(argv[2])) : 1000000;
+    uint32 maxThreads = std::max(4u, std::thread::hardware_concurrency());
+
+    std::vector<BenchPlayer> players;
+    players.reserve(playerCount);
+    for (uint32 i = 1; i <= playerCount; ++i)
+        players.emplace_back(i);
+
+    std::printf("%u players, %u lookups per thread, lookups per ms:\n", playerCount, lookups);
+    std::printf("threads  single lock    sharded\n");
+
+    uint32 wrongLookups = 0;
+    for (uint32 threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double single = Run<SingleLockHolder>(players, threads, lookups, wrongLookups);
+        double sharded = Run<ShardedHolder>(players, threads, lookups, wrongLookups);
+        std::printf("%7u  %11.0f  %9.0f\n", threads, single, sharded);
+    }
+
+    if (wrongLookups)
+    {
+        std::printf("%u lookups returned another player\n", wrongLookups);
+        return 1;
+    }
+
+    return 0;
+}
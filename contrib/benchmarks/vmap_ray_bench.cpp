@@ -0,0 +1,218 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+// Checks the 4-wide leaf kernel of GroupModel::IntersectRay against a brute-force scalar test of every
+// triangle and times it against the previous one-triangle-per-callback BIH traversal.
+// Meshes and rays are random, scattered small triangles in a box the size of a large WMO group.
+// Usage: bench_vmapray [triangles] [rays]
+
+#include "WorldModel.h"
+#include "BIH.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using G3D::Vector3;
+using VMAP::MeshTriangle;
+
+namespace
+{
+    // the triangle test used before the structure of arrays layout, see RTR2 ch. 13.7
+    bool IntersectTriangle(MeshTriangle const& tri, std::vector<Vector3> const& points, G3D::Ray const& ray, float& distance)
+    {
+        Vector3 const idx0 = points[tri.idx0];
+        Vector3 const e1 = points[tri.idx1] - idx0;
+        Vector3 const e2 = points[tri.idx2] - idx0;
+        Vector3 const p(ray.direction().cross(e2));
+        float a = e1.dot(p);
+
+        if (fabs(a) < 1e-5f)
+            return false;
+
+        float const f = 1.0f / a;
+        Vector3 const s(ray.origin() - idx0);
+        float const u = f * s.dot(p);
+
+        if ((u < 0.0f) || (u > 1.0f))
+            return false;
+
+        Vector3 const q(s.cross(e1));
+        float const v = f * ray.direction().dot(q);
+
+        if ((v < 0.0f) || ((u + v) > 1.0f))
+            return false;
+
+        float const t = f * e2.dot(q);
+
+        if ((t > 0.0f) && (t < distance))
+        {
+            distance = t;
+            return true;
+        }
+
+        return false;
+    }
+
+    class TriBoundFunc
+    {
+        public:
+            explicit TriBoundFunc(std::vector<Vector3> const& vert) : vertices(vert) {}
+            void operator()(MeshTriangle const& tri, G3D::AABox& out) const
+            {
+                Vector3 lo = vertices[tri.idx0].min(vertices[tri.idx1]).min(vertices[tri.idx2]);
+                Vector3 hi = vertices[tri.idx0].max(vertices[tri.idx1]).max(vertices[tri.idx2]);
+                out = G3D::AABox(lo, hi);
+            }
+        private:
+            std::vector<Vector3> const& vertices;
+    };
+
+    // the previous GModelRayCallback
+    struct TriangleRayCallback
+    {
+        TriangleRayCallback(std::vector<MeshTriangle> const& tris, std::vector<Vector3> const& vert) : vertices(vert), triangles(tris), hit(false) {}
+        bool operator()(G3D::Ray const& ray, uint32 entry, float& distance, bool /*stopAtFirstHit*/, bool /*ignoreM2Model*/)
+        {
+            if (IntersectTriangle(triangles[entry], vertices, ray, distance))
+                hit = true;
+            return hit;
+        }
+        std::vector<Vector3> const& vertices;
+        std::vector<MeshTriangle> const& triangles;
+        bool hit;
+    };
+
+    struct BenchRay
+    {
+        G3D::Ray ray;
+        float distance;
+    };
+
+    // exposes the mesh of a group model, the model itself keeps it protected
+    class BenchGroupModel : public VMAP::GroupModel
+    {
+        public:
+            BenchGroupModel(std::vector<Vector3> vert, std::vector<MeshTriangle> tri)
+            {
+                setMeshData(vert, tri);
+            }
+            std::vector<Vector3> const& GetVertices() const { return vertices; }
+            std::vector<MeshTriangle> const& GetTriangles() const { return triangles; }
+    };
+
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 triangleCount = argc > 1 ? uint32(std::atoi(argv[1])) : 20000;
+    uint32 rayCount = argc > 2 ? uint32(std::atoi(argv[2])) : 100000;
+
+    std::mt19937 rng(4242);
+    std::uniform_real_distribution<float> position(0.0f, 400.0f);
+    std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+
+    std::vector<Vector3> vertices;
+    std::vector<MeshTriangle> triangles;
+    for (uint32 i = 0; i < triangleCount; ++i)
+    {
+        Vector3 center(position(rng), position(rng), position(rng) / 4.0f);
+        uint32 first = uint32(vertices.size());
+        for (int v = 0; v < 3; ++v)
+            vertices.push_back(center + Vector3(offset(rng), offset(rng), offset(rng)));
+        triangles.push_back(MeshTriangle(first, first + 1, first + 2));
+    }
+
+    BenchGroupModel model(vertices, triangles);
+
+    BIH triangleTree;
+    TriBoundFunc bounds(model.GetVertices());
+    triangleTree.build(model.GetTriangles(), bounds);
+
+    // line of sight style queries, segment between two random points
+    std::vector<BenchRay> rays(rayCount);
+    for (BenchRay& benchRay : rays)
+    {
+        Vector3 start(position(rng), position(rng), position(rng) / 4.0f);
+        Vector3 end(position(rng), position(rng), position(rng) / 4.0f);
+        benchRay.distance = (end - start).length();
+        benchRay.ray = G3D::Ray::fromOriginAndDirection(start, (end - start) / benchRay.distance);
+    }
+
+    std::printf("%u triangles, %u rays\n", triangleCount, rayCount);
+
+    // correctness against every triangle, closest hit and any hit, on a prefix of the rays as it is slow
+    uint32 checkedCount = std::min<uint32>(rayCount, 5000);
+    uint32 mismatches = 0, hits = 0;
+    for (uint32 i = 0; i < checkedCount; ++i)
+    {
+        BenchRay const& benchRay = rays[i];
+        float expected = benchRay.distance;
+        bool expectedHit = false;
+        for (MeshTriangle const& tri : model.GetTriangles())
+            expectedHit |= IntersectTriangle(tri, model.GetVertices(), benchRay.ray, expected);
+
+        float distance = benchRay.distance;
+        bool hit = model.IntersectRay(benchRay.ray, distance, false);
+        float anyDistance = benchRay.distance;
+        bool anyHit = model.IntersectRay(benchRay.ray, anyDistance, true);
+
+        if (hit != expectedHit || anyHit != expectedHit || (hit && distance != expected))
+            ++mismatches;
+        if (hit)
+            ++hits;
+    }
+    std::printf("%u rays checked against brute force: %u hits, %u mismatches\n", checkedCount, hits, mismatches);
+
+    uint32 oldHits = 0, newHits = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (BenchRay const& benchRay : rays)
+    {
+        float distance = benchRay.distance;
+        TriangleRayCallback callback(model.GetTriangles(), model.GetVertices());
+        triangleTree.intersectRay(benchRay.ray, callback, distance, false);
+        oldHits += callback.hit ? 1 : 0;
+    }
+    std::printf("per triangle  %8.1f ms\n", ElapsedMs(start));
+
+    start = std::chrono::steady_clock::now();
+    for (BenchRay const& benchRay : rays)
+    {
+        float distance = benchRay.distance;
+        newHits += model.IntersectRay(benchRay.ray, distance, false) ? 1 : 0;
+    }
+    std::printf("leaf kernel   %8.1f ms\n", ElapsedMs(start));
+
+    if (mismatches || oldHits != newHits)
+    {
+        std::printf("results differ\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -18,6 +18,8 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
@@ -35,12 +37,11 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.back()->m_execTime <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = m_events.back();
+        m_events.pop_back();
 
         if (!Event->to_Abort)
         {
@@ -64,38 +65,27 @@ void EventProcessor::KillAllEvents(bool force)
     m_aborting = true;
 
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    EventList events;
+    std::swap(events, m_events);
+    for (BasicEvent* event : events)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
-
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
-        }
+        event->to_Abort = true;
+        event->Abort(m_time);
+        if (force || event->IsDeletable())
+            delete event;
+        else
+            m_events.push_back(event);                      // kept in order, only deletable events were dropped
     }
-
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
 }
 
 void EventProcessor::KillEvent(BasicEvent* event)
 {
-    for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
-    {
-        if (iter->second == event)
-        {
-            delete iter->second;
-            iter = m_events.erase(iter);
-        }
-        else ++iter;
-    }
+    auto itr = std::find(m_events.begin(), m_events.end(), event);
+    if (itr == m_events.end())
+        return;
+
+    m_events.erase(itr);
+    delete event;
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -104,21 +94,26 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    InsertEvent(Event);
 }
 
-void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
+bool EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
-    {
-        if (itr->second != Event)
-            continue;
+    auto itr = std::find(m_events.begin(), m_events.end(), Event);
+    if (itr == m_events.end())
+        return false;
+
+    m_events.erase(itr);
+    Event->m_execTime = msTime;
+    InsertEvent(Event);
+    return true;
+}
 
-        Event->m_execTime = msTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(msTime, Event));
-        break;
-    }
+void EventProcessor::InsertEvent(BasicEvent* event)
+{
+    // in front of events with the same time, so those added earlier still execute first
+    auto itr = std::partition_point(m_events.begin(), m_events.end(), [time = event->m_execTime](BasicEvent const* queued) { return queued->m_execTime > time; });
+    m_events.insert(itr, event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
@@ -21,7 +21,8 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <vector>
+#include <new>
 
 // Note. All times are in milliseconds here.
 
@@ -55,7 +56,59 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// recycles the memory of frequently created events instead of going through the heap each time
+// free list is kept per thread, objects are updated from their map thread so in practice it is per map
+template<class T>
+class PooledEvent : public BasicEvent
+{
+    public:
+        static void* operator new(std::size_t size)
+        {
+            std::vector<void*>& freeList = GetFreeList().nodes;
+            if (size != sizeof(T) || freeList.empty())
+                return ::operator new(size);
+
+            void* ptr = freeList.back();
+            freeList.pop_back();
+            return ptr;
+        }
+
+        static void operator delete(void* ptr, std::size_t size)
+        {
+            std::vector<void*>& freeList = GetFreeList().nodes;
+            if (size != sizeof(T) || freeList.size() >= MAX_POOLED_EVENTS)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            freeList.push_back(ptr);
+        }
+
+    private:
+        static const std::size_t MAX_POOLED_EVENTS = 4096;
+
+        struct FreeList
+        {
+            ~FreeList()
+            {
+                for (void* ptr : nodes)
+                    ::operator delete(ptr);
+            }
+
+            std::vector<void*> nodes;
+        };
+
+        static FreeList& GetFreeList()
+        {
+            static thread_local FreeList freeList;
+            return freeList;
+        }
+};
+
+// sorted by execution time, the next event to execute is at the back
+// an object has only a handful of events queued so a flat array beats a tree here
+typedef std::vector<BasicEvent*> EventList;
 
 class EventProcessor
 {
@@ -68,11 +121,12 @@ class EventProcessor
         void KillAllEvents(bool force);
         void KillEvent(BasicEvent* Event);
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
-        void ModifyEventTime(BasicEvent* event, uint64 msTime);
+        bool ModifyEventTime(BasicEvent* event, uint64 msTime); // reschedules in place, false if the event is not queued
         uint64 CalculateTime(uint64 t_offset) const;
         EventList& GetEvents() { return m_events; }
 
     protected:
+        void InsertEvent(BasicEvent* event);
 
         uint64 m_time;
         EventList m_events;
@@ -513,7 +513,10 @@ struct SpellBurnDamageBrutallus : public AuraScript
     void OnPeriodicCalculateAmount(Aura* aura, uint32& amount) const override
     {
         if (aura->GetEffIndex() == EFFECT_INDEX_0 && aura->GetAuraTicks() % 11 == 0)
+        {
             aura->GetModifier()-> m_amount *= 2;
+            aura->GetTarget()->InvalidateAuraModifierTotals(aura->GetModifier()->m_auraname);
+        }
 
         amount = aura->GetModifier()->m_amount;
     }
@@ -184,6 +184,7 @@ struct BlessingOfAncientKings : public AuraScript
                 return SPELL_AURA_PROC_OK;
             triggeredAura->GetHolder()->RefreshHolder();
             triggeredAura->GetModifier()->m_amount = std::min(triggeredAura->GetModifier()->m_amount + procData.basepoints[0], 20000);
+            target->InvalidateAuraModifierTotals(triggeredAura->GetModifier()->m_auraname);
             return SPELL_AURA_PROC_CANT_TRIGGER;
         }
         return SPELL_AURA_PROC_OK;
@@ -1140,6 +1140,7 @@ struct spell_seed_of_corruption_npc : public AuraScript
 
         // Damage counting
         mod->m_amount -= procData.damage;
+        procData.triggeredByAura->GetTarget()->InvalidateAuraModifierTotals(mod->m_auraname);
         return SPELL_AURA_PROC_OK;
     }
 };
@@ -1300,6 +1301,7 @@ struct Drink : public DrinkAnimation
         }
 
         regenAura->GetModifier()->m_amount = resultingAmount;
+        aura->GetTarget()->InvalidateAuraModifierTotals(regenAura->GetModifier()->m_auraname);
         ((Player*)aura->GetTarget())->UpdateManaRegen();
     }
 };
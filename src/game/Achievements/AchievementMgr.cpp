@@ -469,6 +469,7 @@ void AchievementMgr::Reset()
 
     m_completedAchievements.clear();
     m_criteriaProgress.clear();
+    m_completedCriteria.clear();
     DeleteFromDB(m_player->GetObjectGuid());
 
     // re-fill data
@@ -848,6 +849,7 @@ void AchievementMgr::StartTimedAchievementCriteria(AchievementCriteriaTypes type
 
         progress->changed = true;
         progress->counter = 0;
+        m_completedCriteria.erase(achievementCriteria->ID);
 
         // Start with given startTime or now
         progress->date = startTime ? startTime : time(nullptr);
@@ -898,6 +900,7 @@ void AchievementMgr::DoFailedTimedAchievementCriterias()
 
             // Remove failed progress
             m_criteriaProgress.erase(pro_iter);
+            m_completedCriteria.erase(criteria->ID);
         }
 
         m_criteriaFailTimes.erase(iter++);
@@ -914,9 +917,13 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, ui
     if (!sWorld.getConfig(CONFIG_BOOL_GM_ALLOW_ACHIEVEMENT_GAINS) && m_player->GetSession()->GetSecurity() > SEC_PLAYER)
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByType(type);
+    // without miscvalue1 (login case) all criteria of the type are checked
+    AchievementCriteriaEntryList const& achievementCriteriaList = miscvalue1 ? sAchievementMgr.GetAchievementCriteriaByAsset(type, miscvalue1) : sAchievementMgr.GetAchievementCriteriaByType(type);
     for (auto achievementCriteria : achievementCriteriaList)
     {
+        if (m_completedCriteria.find(achievementCriteria->ID) != m_completedCriteria.end())
+            continue;
+
         AchievementEntry const* achievement = sAchievementStore.LookupEntry(achievementCriteria->referredAchievement);
         // Checked in LoadAchievementCriteriaList
 
@@ -926,7 +933,12 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, ui
 
         // don't update already completed criteria
         if (IsCompletedCriteria(achievementCriteria, achievement))
+        {
+            // realm first criteria stop being completed once someone else gets the achievement
+            if (!(achievement->flags & (ACHIEVEMENT_FLAG_REALM_FIRST_REACH | ACHIEVEMENT_FLAG_REALM_FIRST_KILL)))
+                m_completedCriteria.insert(achievementCriteria->ID);
             continue;
+        }
 
         // init values, real set in switch
         uint32 change = 0;
@@ -2201,6 +2213,8 @@ void AchievementMgr::SetCriteriaProgress(AchievementCriteriaEntry const* criteri
     uint32 old_value = 0;
     uint32 newValue = 0;
 
+    m_completedCriteria.erase(criteria->ID);
+
     CriteriaProgressMap::iterator iter = m_criteriaProgress.find(criteria->ID);
     if (iter == m_criteriaProgress.end())
     {
@@ -2457,6 +2471,37 @@ AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteria
     return m_AchievementCriteriasByType[type];
 }
 
+// criteria of these types are skipped by UpdateAchievementCriteria unless miscvalue1 matches their asset
+static bool IsCriteriaTypeIndexedByAsset(uint32 type)
+{
+    switch (type)
+    {
+        case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET2:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL2:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_ITEM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByAsset(AchievementCriteriaTypes type, uint32 asset) const
+{
+    if (!IsCriteriaTypeIndexedByAsset(type))
+        return m_AchievementCriteriasByType[type];
+
+    static AchievementCriteriaEntryList const emptyList;
+    auto itr = m_AchievementCriteriasByAsset[type].find(asset);
+    return itr != m_AchievementCriteriasByAsset[type].end() ? itr->second : emptyList;
+}
+
 AchievementCriteriaEntryList const* AchievementGlobalMgr::GetAchievementCriteriaByAchievement(uint32 id)
 {
     AchievementCriteriaListByAchievement::const_iterator itr = m_AchievementCriteriaListByAchievement.find(id);
@@ -2539,6 +2584,8 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
         }
 
         m_AchievementCriteriasByType[criteria->requiredType].push_back(criteria);
+        if (IsCriteriaTypeIndexedByAsset(criteria->requiredType))
+            m_AchievementCriteriasByAsset[criteria->requiredType][criteria->raw.value].push_back(criteria);
         m_AchievementCriteriaListByAchievement[criteria->referredAchievement].push_back(criteria);
         ++count;
     }
@@ -639,16 +639,14 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
-    // Sort
-    AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
+    // only auctions of the narrowest matching class, quality or level bucket are looked at, they are sorted after filtering
     std::vector<AuctionEntry*> auctions;
-    auctions.reserve(aucs.size());
-
-    for (const auto& auc : aucs)
-        auctions.push_back(auc.second);
+    if (isFull)
+        auctionHouse->GetAuctionsForSearch(0xffffffff, 0xffffffff, 0xffffffff, 0x00, 0x00, auctions);
+    else
+        auctionHouse->GetAuctionsForSearch(auctionMainCategory, auctionSubCategory, quality, levelmin, levelmax, auctions);
 
     AuctionSorter sorter(Sort, GetPlayer());
-    std::sort(auctions.begin(), auctions.end(), sorter);
 
     // DEBUG_LOG("Auctionhouse search %s list from: %u, searchedname: %s, levelmin: %u, levelmax: %u, auctionSlotID: %u, auctionMainCategory: %u, auctionSubCategory: %u, quality: %u, usable: %u",
     //  auctioneerGuid.GetString().c_str(), listfrom, searchedname.c_str(), levelmin, levelmax, auctionSlotID, auctionMainCategory, auctionSubCategory, quality, usable);
@@ -665,7 +663,7 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
 
     wstrToLower(wsearchedname);
 
-    BuildListAuctionItems(auctions, data, wsearchedname, listfrom, levelmin, levelmax, usable,
+    BuildListAuctionItems(auctions, sorter, data, wsearchedname, listfrom, levelmin, levelmax, usable,
                           auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, isFull != 0);
 
     data.put<uint32>(0, count);
@@ -33,6 +33,7 @@
 #include "Server/WorldPacket.h"
 #include "Server/WorldSession.h"
 #include "Mails/Mail.h"
+#include "Util/Util.h"
 
 #include "Policies/Singleton.h"
 
@@ -473,12 +474,42 @@ bool AuctionHouseMgr::RemoveAItem(uint32 id)
     return true;
 }
 
+void AuctionHouseMgr::CollectFinishedAuctions()
+{
+    for (auto& mAuction : mAuctions)
+        mAuction.CollectFinishedAuctions();
+}
+
 void AuctionHouseMgr::Update()
 {
     for (auto& mAuction : mAuctions)
         mAuction.Update();
 }
 
+AuctionHouseMgr::AuctionItemName const& AuctionHouseMgr::GetItemName(ItemPrototype const* proto, int32 locIdx)
+{
+    std::map<int32, AuctionItemName>& names = m_itemNames[proto->ItemId].names;
+    auto itr = names.find(locIdx);
+    if (itr != names.end())
+        return itr->second;
+
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(proto->ItemId, locIdx, &name);
+
+    AuctionItemName& itemName = names[locIdx];
+    Utf8toWStr(name, itemName.name);
+    itemName.lowerName = itemName.name;
+    wstrToLower(itemName.lowerName);
+    return itemName;
+}
+
+void AuctionHouseMgr::RemoveItemNameRef(uint32 itemId)
+{
+    auto itr = m_itemNames.find(itemId);
+    if (itr != m_itemNames.end() && --itr->second.refs == 0)
+        m_itemNames.erase(itr);
+}
+
 uint32 AuctionHouseMgr::GetAuctionHouseTeam(AuctionHouseEntry const* house)
 {
     // auction houses have faction field pointing to PLAYER,* factions,
@@ -557,47 +588,199 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
-void AuctionHouseObject::Update()
+std::pair<uint32, uint32> AuctionHouseObject::GetClassIndexKey(AuctionEntry const* auction)
+{
+    if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate))
+        return std::make_pair(proto->Class, proto->SubClass);
+
+    return std::make_pair(uint32(MAX_ITEM_CLASS), uint32(0));
+}
+
+void AuctionHouseObject::RemoveFromIndex(AuctionValueIndex& index, uint32 key, uint32 id)
+{
+    AuctionValueIndex::iterator itr = index.find(key);
+    if (itr == index.end())
+        return;
+
+    itr->second.erase(id);
+    if (itr->second.empty())
+        index.erase(itr);
+}
+
+void AuctionHouseObject::AddAuction(AuctionEntry* ah)
+{
+    MANGOS_ASSERT(ah);
+
+    RemoveAuction(ah->Id);
+    AuctionsMap[ah->Id] = ah;
+    m_classIndex[GetClassIndexKey(ah)][ah->Id] = ah;
+    sAuctionMgr.AddItemNameRef(ah->itemTemplate);
+
+    if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(ah->itemTemplate))
+    {
+        m_qualityIndex[proto->Quality][ah->Id] = ah;
+        m_levelIndex[proto->RequiredLevel][ah->Id] = ah;
+    }
+}
+
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    AuctionClassIndex::iterator indexItr = m_classIndex.find(GetClassIndexKey(itr->second));
+    if (indexItr != m_classIndex.end())
+    {
+        indexItr->second.erase(id);
+        if (indexItr->second.empty())
+            m_classIndex.erase(indexItr);
+    }
+
+    if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(itr->second->itemTemplate))
+    {
+        RemoveFromIndex(m_qualityIndex, proto->Quality, id);
+        RemoveFromIndex(m_levelIndex, proto->RequiredLevel, id);
+    }
+
+    sAuctionMgr.RemoveItemNameRef(itr->second->itemTemplate);
+    AuctionsMap.erase(itr);
+    return true;
+}
+
+void AuctionHouseObject::GetAuctionsForSearch(uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32 levelMin, uint32 levelMax, std::vector<AuctionEntry*>& auctions) const
 {
+    // buckets of each usable index, only the one holding the fewest auctions is copied
+    std::vector<AuctionEntryMap const*> classBuckets, qualityBuckets, levelBuckets;
+    size_t classCount = AuctionsMap.size(), qualityCount = AuctionsMap.size(), levelCount = AuctionsMap.size();
+
+    if (itemClass != 0xffffffff)
+    {
+        classCount = 0;
+        AuctionClassIndex::const_iterator itr = m_classIndex.lower_bound(std::make_pair(itemClass, itemSubClass == 0xffffffff ? 0 : itemSubClass));
+        for (; itr != m_classIndex.end() && itr->first.first == itemClass; ++itr)
+        {
+            if (itemSubClass != 0xffffffff && itr->first.second != itemSubClass)
+                break;
+
+            classBuckets.push_back(&itr->second);
+            classCount += itr->second.size();
+        }
+    }
+
+    if (quality != 0xffffffff)
+    {
+        qualityCount = 0;
+        for (AuctionValueIndex::const_iterator itr = m_qualityIndex.lower_bound(quality); itr != m_qualityIndex.end(); ++itr)
+        {
+            qualityBuckets.push_back(&itr->second);
+            qualityCount += itr->second.size();
+        }
+    }
+
+    if (levelMin != 0x00)
+    {
+        levelCount = 0;
+        AuctionValueIndex::const_iterator end = levelMax != 0x00 ? m_levelIndex.upper_bound(std::max(levelMin, levelMax)) : m_levelIndex.end();
+        for (AuctionValueIndex::const_iterator itr = m_levelIndex.lower_bound(levelMin); itr != end; ++itr)
+        {
+            levelBuckets.push_back(&itr->second);
+            levelCount += itr->second.size();
+        }
+    }
+
+    std::vector<AuctionEntryMap const*> const* buckets = nullptr;
+    size_t count = AuctionsMap.size();
+    if (itemClass != 0xffffffff && classCount <= count)
+    {
+        buckets = &classBuckets;
+        count = classCount;
+    }
+    if (quality != 0xffffffff && qualityCount < count)
+    {
+        buckets = &qualityBuckets;
+        count = qualityCount;
+    }
+    if (levelMin != 0x00 && levelCount < count)
+    {
+        buckets = &levelBuckets;
+        count = levelCount;
+    }
+
+    auctions.reserve(count);
+
+    if (!buckets)
+    {
+        for (auto const& auction : AuctionsMap)
+            auctions.push_back(auction.second);
+        return;
+    }
+
+    for (AuctionEntryMap const* bucket : *buckets)
+        for (auto const& auction : *bucket)
+            auctions.push_back(auction.second);
+}
+
+void AuctionHouseObject::CollectFinishedAuctions()
+{
+    m_finishedAuctions.clear();
+    m_finishedAuctionsCollected = true;
+
     time_t curTime = sWorld.GetGameTime();
-    ///- Handle expired auctions
-    for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end();)
+    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
     {
         if (itr->second->moneyDeliveryTime)                 // pending auction
         {
             if (curTime > itr->second->moneyDeliveryTime)
-            {
-                sAuctionMgr.SendAuctionSuccessfulMail(itr->second);
+                m_finishedAuctions.push_back(itr->first);
+        }
+        else if (curTime > itr->second->expireTime)         // active auction
+            m_finishedAuctions.push_back(itr->first);
+    }
+}
 
-                itr->second->DeleteFromDB();
-                MANGOS_ASSERT(!itr->second->itemGuidLow);   // already removed or send in mail at won
-                delete itr->second;
-                AuctionsMap.erase(itr++);
-                continue;
-            }
+void AuctionHouseObject::Update()
+{
+    if (!m_finishedAuctionsCollected)
+        CollectFinishedAuctions();
+
+    m_finishedAuctionsCollected = false;
+
+    ///- Handle expired auctions
+    for (uint32 auctionId : m_finishedAuctions)
+    {
+        AuctionEntryMap::iterator itr = AuctionsMap.find(auctionId);
+        if (itr == AuctionsMap.end())
+            continue;
+
+        AuctionEntry* auction = itr->second;
+        if (auction->moneyDeliveryTime)                     // pending auction
+        {
+            sAuctionMgr.SendAuctionSuccessfulMail(auction);
+
+            auction->DeleteFromDB();
+            MANGOS_ASSERT(!auction->itemGuidLow);           // already removed or send in mail at won
+            RemoveAuction(auctionId);
+            delete auction;
         }
         else                                                // active auction
         {
-            if (curTime > itr->second->expireTime)
+            ///- perform the transaction if there was bidder
+            if (auction->bid)
+                auction->AuctionBidWinning();
+            ///- cancel the auction if there was no bidder and clear the auction
+            else
             {
-                ///- perform the transaction if there was bidder
-                if (itr->second->bid)
-                    itr->second->AuctionBidWinning();
-                ///- cancel the auction if there was no bidder and clear the auction
-                else
-                {
-                    sAuctionMgr.SendAuctionExpiredMail(itr->second);
+                sAuctionMgr.SendAuctionExpiredMail(auction);
 
-                    itr->second->DeleteFromDB();
-                    delete itr->second;
-                    AuctionsMap.erase(itr++);
-                    continue;
-                }
+                auction->DeleteFromDB();
+                RemoveAuction(auctionId);
+                delete auction;
             }
         }
-
-        ++itr;
     }
+
+    m_finishedAuctions.clear();
 }
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount)
@@ -709,16 +892,7 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
 
             int32 loc_idx = viewPlayer->GetSession()->GetSessionDbLocaleIndex();
 
-            std::string name1 = itemProto1->Name1;
-            sObjectMgr.GetItemLocaleStrings(itemProto1->ItemId, loc_idx, &name1);
-
-            std::string name2 = itemProto2->Name1;
-            sObjectMgr.GetItemLocaleStrings(itemProto2->ItemId, loc_idx, &name2);
-
-            std::wstring wname1, wname2;
-            Utf8toWStr(name1, wname1);
-            Utf8toWStr(name2, wname2);
-            return wname1.compare(wname2);
+            return sAuctionMgr.GetItemName(itemProto1, loc_idx).name.compare(sAuctionMgr.GetItemName(itemProto2, loc_idx).name);
         }
         case 6:                                             // minbidbuyout = 6
         {
@@ -800,11 +974,14 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
     return false;                                           // "equal" by all sorts
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
+void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, AuctionSorter const& sorter, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
         uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const
 {
     int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
 
+    std::vector<AuctionEntry*> matches;
+    matches.reserve(auctions.size());
+
     for (auto Aentry : auctions)
     {
         if (Aentry->moneyDeliveryTime)
@@ -813,12 +990,7 @@ void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& aucti
         if (!item)
             continue;
 
-        if (isFull)
-        {
-            ++count;
-            Aentry->BuildAuctionInfo(data);
-        }
-        else
+        if (!isFull)
         {
             ItemPrototype const* proto = item->GetProto();
 
@@ -860,20 +1032,31 @@ void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& aucti
                 }
             }
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
-
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
+            if (!wsearchedname.empty() && sAuctionMgr.GetItemName(proto, loc_idx).lowerName.find(wsearchedname) == std::wstring::npos)
                 continue;
-
-            if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= listfrom)
-            {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
-            }
         }
 
-        ++totalcount;
+        matches.push_back(Aentry);
+    }
+
+    totalcount = matches.size();
+
+    // full list is sent completely, otherwise only the requested page needs to be in order
+    size_t first = isFull ? 0 : std::min<size_t>(listfrom, matches.size());
+    size_t last = isFull ? matches.size() : std::min<size_t>(first + MAX_AUCTION_ITEMS_CLIENT_UI_PAGE, matches.size());
+
+    if (sorter.IsSorted())
+    {
+        if (last == matches.size())
+            std::sort(matches.begin(), matches.end(), sorter);
+        else
+            std::partial_sort(matches.begin(), matches.begin() + last, matches.end(), sorter);
+    }
+
+    for (size_t i = first; i < last; ++i)
+    {
+        ++count;
+        matches[i]->BuildAuctionInfo(data);
     }
 }
 
@@ -24,6 +24,7 @@
 
 class Item;
 class Player;
+struct ItemPrototype;
 class Unit;
 class WorldPacket;
 
@@ -100,17 +101,17 @@ class AuctionHouseObject
 
         typedef std::map<uint32, AuctionEntry*> AuctionEntryMap;
         typedef std::pair<AuctionEntryMap::const_iterator, AuctionEntryMap::const_iterator> AuctionEntryMapBounds;
+        // auctions by item class and subclass of the auctioned item
+        typedef std::map<std::pair<uint32, uint32>, AuctionEntryMap> AuctionClassIndex;
+        // auctions by quality or by required level of the auctioned item
+        typedef std::map<uint32, AuctionEntryMap> AuctionValueIndex;
 
         uint32 GetCount() const { return AuctionsMap.size(); }
 
         AuctionEntryMap const& GetAuctions() const { return AuctionsMap; }
         AuctionEntryMapBounds GetAuctionsBounds() const {return AuctionEntryMapBounds(AuctionsMap.begin(), AuctionsMap.end()); }
 
-        void AddAuction(AuctionEntry* ah)
-        {
-            MANGOS_ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
-        }
+        void AddAuction(AuctionEntry* ah);
 
         AuctionEntry* GetAuction(uint32 id) const
         {
@@ -118,11 +119,14 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : nullptr;
         }
 
-        bool RemoveAuction(uint32 id)
-        {
-            return AuctionsMap.erase(id) > 0;
-        }
+        bool RemoveAuction(uint32 id);
+
+        // candidates for a browse request, taken from the narrowest of the class, quality and level indexes
+        // 0xffffffff selects every class, subclass or quality, levelMin 0 every level; the caller still filters them
+        void GetAuctionsForSearch(uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32 levelMin, uint32 levelMax, std::vector<AuctionEntry*>& auctions) const;
 
+        // collects expired and pending auctions, only reads the auction entries so it may run alongside map updates
+        void CollectFinishedAuctions();
         void Update();
 
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
@@ -131,7 +135,15 @@ class AuctionHouseObject
 
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
     private:
+        static std::pair<uint32, uint32> GetClassIndexKey(AuctionEntry const* auction);
+        static void RemoveFromIndex(AuctionValueIndex& index, uint32 key, uint32 id);
+
         AuctionEntryMap AuctionsMap;
+        AuctionClassIndex m_classIndex;
+        AuctionValueIndex m_qualityIndex;
+        AuctionValueIndex m_levelIndex;
+        std::vector<uint32> m_finishedAuctions;
+        bool m_finishedAuctionsCollected = false;
 };
 
 class AuctionSorter
@@ -140,6 +152,7 @@ class AuctionSorter
         AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_viewPlayer(sorter.m_viewPlayer) {}
         AuctionSorter(uint8* sort, Player* viewPlayer) : m_sort(sort), m_viewPlayer(viewPlayer) {}
         bool operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const;
+        bool IsSorted() const { return m_sort[0] != MAX_AUCTION_SORT; }
 
     private:
         uint8* m_sort;
@@ -185,6 +198,17 @@ class AuctionHouseMgr
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
         static AuctionHouseEntry const* GetAuctionHouseEntry(Unit* unit);
 
+        // localized item name as wide string, kept for name sorting and searches of the auction list
+        struct AuctionItemName
+        {
+            std::wstring name;
+            std::wstring lowerName;
+        };
+        // only for item templates with auctions listed, their names are dropped together with the last such auction
+        AuctionItemName const& GetItemName(ItemPrototype const* proto, int32 locIdx);
+        void AddItemNameRef(uint32 itemId) { ++m_itemNames[itemId].refs; }
+        void RemoveItemNameRef(uint32 itemId);
+
     public:
         // load first auction items, because of check if item exists, when loading
         void LoadAuctionItems();
@@ -193,12 +217,20 @@ class AuctionHouseMgr
         void AddAItem(Item* it);
         bool RemoveAItem(uint32 id);
 
+        void CollectFinishedAuctions();
         void Update();
 
     private:
         AuctionHouseObject  mAuctions[MAX_AUCTION_HOUSE_TYPE];
 
         ItemMap             mAitems;
+
+        struct AuctionItemNames
+        {
+            uint32 refs = 0;
+            std::map<int32, AuctionItemName> names;         // by locale index
+        };
+        std::unordered_map<uint32, AuctionItemNames> m_itemNames;
 };
 
 #define sAuctionMgr MaNGOS::Singleton<AuctionHouseMgr>::Instance()
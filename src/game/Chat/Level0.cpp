@@ -23,6 +23,7 @@
 #include "Server/Opcodes.h"
 #include "Chat/Chat.h"
 #include "Globals/ObjectAccessor.h"
+#include "Globals/WhoListIndex.h"
 #include "Tools/Language.h"
 #include "Accounts/AccountMgr.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
@@ -157,18 +158,14 @@ bool ChatHandler::HandleGMListIngameCommand(char* /*args*/)
 {
     std::list< std::pair<std::string, bool> > names;
 
+    // game masters always have an account above SEC_PLAYER
+    sWhoListIndex.DoForStaff([&](Player* player)
     {
-        HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-        HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-        for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
-        {
-            Player* player = itr->second;
-            AccountTypes security = player->GetSession()->GetSecurity();
-            if ((player->IsGameMaster() || (security > SEC_PLAYER && security <= (AccountTypes)sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_GM_LIST))) &&
-                (!m_session || player->IsVisibleGloballyFor(m_session->GetPlayer())))
-                names.push_back(std::make_pair<std::string, bool>(GetNameLink(player), player->isAcceptWhispers()));
-        }
-    }
+        AccountTypes security = player->GetSession()->GetSecurity();
+        if ((player->IsGameMaster() || (security > SEC_PLAYER && security <= (AccountTypes)sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_GM_LIST))) &&
+            (!m_session || player->IsVisibleGloballyFor(m_session->GetPlayer())))
+            names.push_back(std::make_pair<std::string, bool>(GetNameLink(player), player->isAcceptWhispers()));
+    });
 
     if (!names.empty())
     {
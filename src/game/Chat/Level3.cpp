@@ -31,6 +31,7 @@
 #include "Guilds/Guild.h"
 #include "Guilds/GuildMgr.h"
 #include "Globals/ObjectAccessor.h"
+#include "Globals/WhoListIndex.h"
 #include "Maps/MapManager.h"
 #include "Mails/MassMailMgr.h"
 #include "DBScripts/ScriptMgr.h"
@@ -1175,6 +1176,7 @@ bool ChatHandler::HandleAccountSetGmLevelCommand(char* args)
     {
         ChatHandler(targetPlayer).PSendSysMessage(LANG_YOURS_SECURITY_CHANGED, GetNameLink().c_str(), gm);
         targetPlayer->GetSession()->SetSecurity(AccountTypes(gm));
+        sWhoListIndex.AddPlayer(targetPlayer);              // refresh the staff list used by .gm ingame
     }
 
     PSendSysMessage(LANG_YOU_CHANGE_SECURITY, targetAccountName.c_str(), gm);
@@ -5243,9 +5245,10 @@ bool ChatHandler::HandleResetAllCommand(char* args)
     }
 
     CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE (at_login & '%u') = '0'", atLogin, atLogin);
-    HashMapHolder<Player>::MapType const& plist = sObjectAccessor.GetPlayers();
-    for (const auto& itr : plist)
-        itr.second->SetAtLoginFlag(atLogin);
+    sObjectAccessor.ExecuteOnAllPlayers([atLogin](Player* player)
+    {
+        player->SetAtLoginFlag(atLogin);
+    });
 
     return true;
 }
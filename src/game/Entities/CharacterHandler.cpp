@@ -662,6 +662,7 @@ void PlayerbotMgr::LoginPlayerBot(ObjectGuid playerGuid)
         delete holder;                                      // delete all unprocessed queries
         return;
     }
+    SqlOrderingKey orderingKey(accountId);
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerBotLoginCallback, holder);
 }
 #endif
@@ -1231,6 +1232,9 @@ void WorldSession::HandleChangePlayerNameOpcodeCallBack(QueryResult* result, uin
 
     delete result;
 
+    // callbacks run outside of the session update, keep the order with the next character list request
+    SqlOrderingKey orderingKey(accountId);
+
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("UPDATE characters set name = '%s', at_login = at_login & ~ %u WHERE guid ='%u'", newname.c_str(), uint32(AT_LOGIN_RENAME), guidLow);
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guidLow);
@@ -168,7 +168,7 @@ void Creature::AddToWorld()
     if (!IsInWorld())
     {
         if (GetObjectGuid().IsCreatureOrVehicle())
-            GetMap()->GetObjectsStore().insert<Creature>(GetObjectGuid(), (Creature*)this);
+            GetMap()->InsertObject<Creature>(GetObjectGuid(), (Creature*)this);
         if (GetDbGuid())
             GetMap()->AddDbGuidObject(this);
     }
@@ -207,7 +207,7 @@ void Creature::RemoveFromWorld()
     if (IsInWorld())
     {
         if (GetObjectGuid().IsCreatureOrVehicle())
-            GetMap()->GetObjectsStore().erase<Creature>(GetObjectGuid(), (Creature*)nullptr);
+            GetMap()->EraseObject<Creature>(GetObjectGuid(), (Creature*)nullptr);
         if (GetDbGuid())
             GetMap()->RemoveDbGuidObject(this);
 
@@ -123,7 +123,7 @@ void GameObject::AddToWorld()
     ///- Register the gameobject for guid lookup
     if (!IsInWorld())
     {
-        GetMap()->GetObjectsStore().insert<GameObject>(GetObjectGuid(), (GameObject*)this);
+        GetMap()->InsertObject<GameObject>(GetObjectGuid(), (GameObject*)this);
         if (GetDbGuid())
             GetMap()->AddDbGuidObject(this);
     }
@@ -171,7 +171,7 @@ void GameObject::RemoveFromWorld()
         if (m_model && GetMap()->ContainsGameObjectModel(*m_model))
             GetMap()->RemoveGameObjectModel(*m_model);
 
-        GetMap()->GetObjectsStore().erase<GameObject>(GetObjectGuid(), (GameObject*)nullptr);
+        GetMap()->EraseObject<GameObject>(GetObjectGuid(), (GameObject*)nullptr);
         if (GetDbGuid())
             GetMap()->RemoveDbGuidObject(this);
 
@@ -2184,6 +2184,7 @@ void GameObject::UpdateCollisionState() const
         return;
 
     m_model->enable(IsCollisionEnabled() ? GetPhaseMask() : 0);
+    GetMap()->OnGameObjectModelChanged(*m_model);
 }
 
 void GameObject::UpdateModel()
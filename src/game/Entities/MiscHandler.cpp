@@ -36,6 +36,7 @@
 #include "Maps/InstanceData.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "Globals/ObjectAccessor.h"
+#include "Globals/WhoListIndex.h"
 #include "Entities/Object.h"
 #include "BattleGround/BattleGround.h"
 #include "OutdoorPvP/OutdoorPvP.h"
@@ -140,134 +141,53 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     if (level_max >= MAX_LEVEL)
         level_max = STRONG_MAX_LEVEL;
 
-    Team team = _player->GetTeam();
     uint32 security = GetSecurity();
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
     AccountTypes gmLevelInWhoList = (AccountTypes)sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST);
 
-    uint32 matchcount = 0;
-    uint32 displaycount = 0;
-
-    WorldPacket data(SMSG_WHO, 50);                         // guess size
-    data << uint32(matchcount);                             // placeholder, count of players matching criteria
-    data << uint32(displaycount);                           // placeholder, count of players displayed
-
-    // TODO: Guard Player map
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
-    {
-        Player* pl = itr->second;
-
-        if (security == SEC_PLAYER)
-        {
-            // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
-            if (pl->GetTeam() != team && !allowTwoSideWhoList)
-                continue;
-
-            // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
-            if (pl->GetSession()->GetSecurity() > gmLevelInWhoList)
-                continue;
-        }
-
-        // do not process players which are not in world
-        if (!pl->IsInWorld())
-            continue;
-
-        // check if target is globally visible for player
-        if (!pl->IsVisibleGloballyFor(_player))
-            continue;
-
-        // check if target's level is in level range
-        uint32 lvl = pl->GetLevel();
-        if (lvl < level_min || lvl > level_max)
-            continue;
-
-        // check if class matches classmask
-        uint32 class_ = pl->getClass();
-        if (!(classmask & (1 << class_)))
-            continue;
-
-        // check if race matches racemask
-        uint32 race = pl->getRace();
-        if (!(racemask & (1 << race)))
-            continue;
-
-        uint32 pzoneid = pl->GetZoneId();
-        uint8 gender = pl->getGender();
-
-        bool z_show = true;
-        for (uint32 i = 0; i < zones_count; ++i)
-        {
-            if (zoneids[i] == pzoneid)
-            {
-                z_show = true;
-                break;
-            }
-
-            z_show = false;
-        }
-        if (!z_show)
-            continue;
-
-        std::string pname = pl->GetName();
-        std::wstring wpname;
-        if (!Utf8toWStr(pname, wpname))
-            continue;
-        wstrToLower(wpname);
-
-        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
-            continue;
-
-        std::string gname = sGuildMgr.GetGuildNameById(pl->GetGuildId());
-        std::wstring wgname;
-        if (!Utf8toWStr(gname, wgname))
-            continue;
-        wstrToLower(wgname);
-
-        if (!(wguild_name.empty() || wgname.find(wguild_name) != std::wstring::npos))
-            continue;
-
-        std::string aname;
-        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(pzoneid))
-            aname = areaEntry->area_name[GetSessionDbcLocale()];
-
-        bool s_show = true;
-        for (uint32 i = 0; i < str_count; ++i)
-        {
-            if (!str[i].empty())
-            {
-                if (wgname.find(str[i]) != std::wstring::npos ||
-                        wpname.find(str[i]) != std::wstring::npos ||
-                        Utf8FitTo(aname, str[i]))
-                {
-                    s_show = true;
-                    break;
-                }
-                s_show = false;
-            }
-        }
-        if (!s_show)
-            continue;
+    WhoListQuery query;
+    query.searcher = _player;
+    // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
+    query.allTeams = security > SEC_PLAYER || allowTwoSideWhoList;
+    query.hideGameMasters = security == SEC_PLAYER;
+    query.maxSecurity = gmLevelInWhoList;
+    query.levelMin = level_min;
+    query.levelMax = level_max;
+    query.raceMask = racemask;
+    query.classMask = classmask;
+    for (uint32 i = 0; i < zones_count; ++i)
+        if (std::find(query.zoneIds.begin(), query.zoneIds.end(), zoneids[i]) == query.zoneIds.end())
+            query.zoneIds.push_back(zoneids[i]);
+    query.playerName = wplayer_name;
+    query.guildName = wguild_name;
+    for (uint32 i = 0; i < str_count; ++i)
+        if (!str[i].empty())
+            query.strings.push_back(str[i]);
+    query.locale = GetSessionDbcLocale();
 
-        // 49 is maximum player count sent to client
-        if (++matchcount > 49)
-            continue;
+    // 49 is maximum player count sent to client
+    std::vector<WhoListResult> results;
+    uint32 matchcount = sWhoListIndex.Query(query, results, 49, sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS));
+    uint32 displaycount = results.size();
 
-        ++displaycount;
+    WorldPacket data(SMSG_WHO, 8 + displaycount * 40);      // guess size
+    data << uint32(displaycount);                           // count of players displayed
+    data << uint32(0);                                      // placeholder, count of players matching criteria
 
-        data << pname;                                      // player name
-        data << gname;                                      // guild name
-        data << uint32(lvl);                                // player level
-        data << uint32(class_);                             // player class
-        data << uint32(race);                               // player race
-        data << uint8(gender);                              // player gender
-        data << uint32(pzoneid);                            // player zone id
+    for (WhoListResult const& result : results)
+    {
+        data << result.name;                                // player name
+        data << result.guildName;                           // guild name
+        data << uint32(result.level);                       // player level
+        data << uint32(result.classId);                     // player class
+        data << uint32(result.race);                        // player race
+        data << uint8(result.gender);                       // player gender
+        data << uint32(result.zoneId);                      // player zone id
     }
 
     if (sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS) && matchcount > sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS))
         matchcount = sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS);
 
-    data.put(0, displaycount);                              // insert right count, count displayed
     data.put(4, matchcount);                                // insert right count, count of matches
 
     SendPacket(data);
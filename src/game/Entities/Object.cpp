@@ -217,6 +217,90 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target) c
         BuildValuesUpdateBlockForPlayer(data, updateMask, target);
 }
 
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target, UpdateBlockCacheType& sharedBlocks) const
+{
+    uint16 const* flags = nullptr;
+    uint16 visibleFlag = GetUpdateFieldFlagsForTarget(target, flags);
+    MANGOS_ASSERT(flags);
+
+    // fields whose value does not depend on the viewer are serialized once per visibility class
+    auto sharedItr = sharedBlocks.find(visibleFlag);
+    if (sharedItr == sharedBlocks.end())
+    {
+        UpdateMask sharedMask;
+        sharedMask.SetCount(m_valuesCount);
+
+        for (uint16 index = 0; index < m_valuesCount; ++index)
+            if (m_changedValues[index] && (flags[index] & visibleFlag) && !IsUpdateFieldPerViewer(index))
+                sharedMask.SetBit(index);
+
+        ByteBuffer buf;
+        if (sharedMask.HasData())
+        {
+            buf.reserve(500);
+            buf << uint8(UPDATETYPE_VALUES);
+            buf << GetPackGUID();
+
+            BuildValuesUpdateFields(&buf, &sharedMask, target, false, false);
+        }
+
+        sharedItr = sharedBlocks.emplace(visibleFlag, std::move(buf)).first;
+    }
+
+    UpdateMask viewerMask;
+    viewerMask.SetCount(m_valuesCount);
+
+    for (uint16 index = 0; index < m_valuesCount; ++index)
+        if (m_changedValues[index] && (flags[index] & visibleFlag) && IsUpdateFieldPerViewer(index))
+            viewerMask.SetBit(index);
+
+    if (!sharedItr->second.empty())
+    {
+        data.AddUpdateBlock(sharedItr->second);
+
+        // BuildValuesUpdate resends these per viewer fields with every values update
+        if (isType(TYPEMASK_GAMEOBJECT) && !static_cast<GameObject const*>(this)->IsDynTransport())
+            viewerMask.SetBit(GAMEOBJECT_DYNAMIC);
+        else if (isType(TYPEMASK_UNIT) && static_cast<Unit const*>(this)->HasAuraState(AURA_STATE_CONFLAGRATE))
+            viewerMask.SetBit(UNIT_FIELD_AURASTATE);
+    }
+
+    if (viewerMask.HasData())
+        BuildValuesUpdateBlockForPlayer(data, viewerMask, target);
+}
+
+bool Object::IsUpdateFieldPerViewer(uint16 index) const
+{
+    if (isType(TYPEMASK_UNIT))
+    {
+        switch (index)
+        {
+            case UNIT_FIELD_FLAGS:
+            case UNIT_DYNAMIC_FLAGS:
+                return true;
+            case UNIT_NPC_FLAGS:
+                return GetTypeId() == TYPEID_UNIT;
+            case UNIT_FIELD_AURASTATE:
+                return static_cast<Unit const*>(this)->HasAuraState(AURA_STATE_CONFLAGRATE);
+            case UNIT_FIELD_HEALTH:
+            case UNIT_FIELD_MAXHEALTH:
+                return sWorld.getConfig(CONFIG_UINT32_FOGOFWAR_HEALTH) < 2;
+            case UNIT_FIELD_FACTIONTEMPLATE:
+                return GetTypeId() == TYPEID_PLAYER && sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP);
+            default:
+                return false;
+        }
+    }
+
+    if (isType(TYPEMASK_CORPSE))
+        return index == CORPSE_FIELD_BYTES_1 && sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP);
+
+    if (isType(TYPEMASK_GAMEOBJECT) && !static_cast<GameObject const*>(this)->IsDynTransport())
+        return index == GAMEOBJECT_DYNAMIC || index == GAMEOBJECT_BYTES_1;
+
+    return false;
+}
+
 void Object::BuildValuesUpdateBlockForPlayerWithFlags(UpdateData& data, Player* target, UpdateFieldFlags flags) const
 {
     UpdateMask updateMask;
@@ -519,6 +603,11 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
         }
     }
 
+    BuildValuesUpdateFields(data, updateMask, target, IsActivateToQuest, IsPerCasterAuraState);
+}
+
+void Object::BuildValuesUpdateFields(ByteBuffer* data, UpdateMask* updateMask, Player* target, bool IsActivateToQuest, bool IsPerCasterAuraState) const
+{
     MANGOS_ASSERT(updateMask && updateMask->GetCount() == m_valuesCount);
 
     *data << (uint8)updateMask->GetBlockCount();
@@ -1249,6 +1338,20 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
     BuildValuesUpdateBlockForPlayer(iter->second, iter->first);
 }
 
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, UpdateBlockCacheType& sharedBlocks) const
+{
+    UpdateDataMapType::iterator iter = update_players.find(pl);
+
+    if (iter == update_players.end())
+    {
+        std::pair<UpdateDataMapType::iterator, bool> p = update_players.insert(UpdateDataMapType::value_type(pl, UpdateData()));
+        MANGOS_ASSERT(p.second);
+        iter = p.first;
+    }
+
+    BuildValuesUpdateBlockForPlayer(iter->second, iter->first, sharedBlocks);
+}
+
 void Object::AddToClientUpdateList()
 {
     sLog.outError("Unexpected call of Object::AddToClientUpdateList for object (TypeId: %u Update fields: %u)", GetTypeId(), m_valuesCount);
@@ -2661,12 +2764,13 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
+    UpdateBlockCacheType i_sharedBlocks;                    // values blocks of i_object per visibility class, for this flush only
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
         if (i_object.isType(TYPEMASK_PLAYER))
-            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas);
+            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas, i_sharedBlocks);
     }
 
     void Visit(CameraMapType& m)
@@ -2675,7 +2779,7 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter.getSource()->GetOwner();
             if (owner != &i_object && owner->HasAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, i_sharedBlocks);
         }
     }
 
@@ -121,6 +121,7 @@ class Spell;
 class GenericTransport;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
+typedef std::unordered_map<uint16, ByteBuffer> UpdateBlockCacheType;     // visible update field flags -> values block shared by those viewers
 
 // Spell cooldown flags sent in SMSG_SPELL_COOLDOWN
 enum SpellCooldownFlags
@@ -229,7 +230,7 @@ class CooldownContainer
             {
                 auto& cd = spellCDItr->second;
                 if (cd->IsSpellCDExpired(now) && cd->IsCatCDExpired(now)) // will not remove permanent CD
-                    spellCDItr = erase(spellCDItr);
+                    spellCDItr = EraseEntry(spellCDItr);    // expired cooldowns are skipped at load, no version change
                 else
                 {
                     if (cd->m_category && cd->IsCatCDExpired(now))
@@ -245,6 +246,7 @@ class CooldownContainer
         bool AddCooldown(TimePoint clockNow, uint32 spellId, uint32 duration, uint32 spellCategory = 0, uint32 categoryDuration = 0, uint32 itemId = 0, bool onHold = false)
         {
             RemoveBySpellId(spellId);
+            ++m_version;
             auto resultItr = m_spellIdMap.emplace(spellId, std::make_unique<CooldownData>(clockNow, spellId, duration, spellCategory, categoryDuration, itemId, onHold));
             // do not overwrite one permanent category cooldown with another permanent category cooldown
             if (resultItr.second && spellCategory && categoryDuration)
@@ -282,6 +284,7 @@ class CooldownContainer
                         m_categoryMap.erase(catCDItr);
                 }
                 m_spellIdMap.erase(spellCDItr);
+                ++m_version;
             }
         }
 
@@ -292,19 +295,14 @@ class CooldownContainer
             {
                 spellCDItr->second->second->m_category = 0;
                 m_categoryMap.erase(spellCDItr);
+                ++m_version;
             }
         }
 
         Iterator erase(ConstIterator spellCDItr)
         {
-            auto& cdData = spellCDItr->second;
-            if (cdData->m_category)
-            {
-                auto catCDItr = m_categoryMap.find(cdData->m_category);
-                if (catCDItr != m_categoryMap.end())
-                    m_categoryMap.erase(catCDItr);
-            }
-            return m_spellIdMap.erase(spellCDItr);
+            ++m_version;
+            return EraseEntry(spellCDItr);
         }
 
         ConstIterator FindBySpellId(uint32 id) const { return m_spellIdMap.find(id); }
@@ -315,16 +313,33 @@ class CooldownContainer
             return itr != m_categoryMap.end() ? itr->second : end();
         }
 
-        void clear() { m_spellIdMap.clear(); m_categoryMap.clear(); }
+        void clear() { m_spellIdMap.clear(); m_categoryMap.clear(); ++m_version; }
 
         ConstIterator begin() const { return m_spellIdMap.begin(); }
         ConstIterator end() const { return m_spellIdMap.end(); }
         bool IsEmpty() const { return m_spellIdMap.empty(); }
         size_t size() const { return m_spellIdMap.size(); }
 
+        // changes on every added, removed or modified cooldown, used to skip saving an unchanged container
+        uint32 GetVersion() const { return m_version; }
+        void SetModified() { ++m_version; }
+
     private:
+        Iterator EraseEntry(ConstIterator spellCDItr)
+        {
+            auto& cdData = spellCDItr->second;
+            if (cdData->m_category)
+            {
+                auto catCDItr = m_categoryMap.find(cdData->m_category);
+                if (catCDItr != m_categoryMap.end())
+                    m_categoryMap.erase(catCDItr);
+            }
+            return m_spellIdMap.erase(spellCDItr);
+        }
+
         spellIdMap m_spellIdMap;
         categoryMap m_categoryMap;
+        uint32 m_version = 0;
 };
 
 struct Position
@@ -438,6 +453,7 @@ class Object
         void SendForcedObjectUpdate();
 
         void BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target, UpdateBlockCacheType& sharedBlocks) const;
         void BuildValuesUpdateBlockForPlayerWithFlags(UpdateData& data, Player* target, UpdateFieldFlags flags) const;
         void BuildValuesUpdateBlockForPlayer(UpdateData& data, UpdateMask& updateMask, Player* target) const;
         void BuildForcedValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
@@ -652,7 +668,10 @@ class Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
+        void BuildValuesUpdateFields(ByteBuffer* data, UpdateMask* updateMask, Player* target, bool IsActivateToQuest, bool IsPerCasterAuraState) const;
+        bool IsUpdateFieldPerViewer(uint16 index) const;
         void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, UpdateBlockCacheType& sharedBlocks) const;
 
         uint16 m_objectType;
 
@@ -40,6 +40,7 @@
 #include "Grids/CellImpl.h"
 #include "Globals/ObjectMgr.h"
 #include "Globals/ObjectAccessor.h"
+#include "Globals/WhoListIndex.h"
 #include "Tools/Formulas.h"
 #include "Groups/Group.h"
 #include "Guilds/Guild.h"
@@ -574,6 +575,11 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_currentBuybackSlot = BUYBACK_SLOT_START;
 
     m_DailyQuestChanged = false;
+    m_characterSaved = false;
+    m_enteredInstancesChanged = false;
+    m_aurasChanged = true;
+    m_statsChanged = true;
+    m_savedCooldownsVersion = 0;
     m_WeeklyQuestChanged = false;
 
     m_lastLiquid = nullptr;
@@ -2354,6 +2360,7 @@ void Player::ProcessDelayedOperations()
         {
             CastSpell(this, m_bgData.mountSpell, TRIGGERED_OLD_TRIGGERED);
             m_bgData.mountSpell = 0;
+            m_bgData.m_needSave = true;
         }
     }
 
@@ -4083,6 +4090,12 @@ void Player::_LoadSpellCooldowns(std::unique_ptr<QueryResult> queryResult)
 
 void Player::_SaveSpellCooldowns()
 {
+    // expire times are absolute, an unchanged container has nothing new to write
+    if (m_cooldownMap.GetVersion() == m_savedCooldownsVersion)
+        return;
+
+    m_savedCooldownsVersion = m_cooldownMap.GetVersion();
+
     static SqlStatementID deleteSpellCooldown;
 
     // delete all old cooldown
@@ -4509,33 +4522,40 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
     // bones will be deleted by corpse/bones deleting thread shortly
     sObjectAccessor.ConvertCorpseForPlayer(playerguid);
 
-    // remove from guild
-    if (uint32 guildId = GetGuildIdFromDB(playerguid))
+    // guild, arena team, group and petition rows are shared with other accounts: keep them in the shared order
     {
-        if (Guild* guild = sGuildMgr.GetGuildById(guildId))
+        SqlOrderingKey sharedOrderingKey(0);
+
+        // remove from guild
+        if (uint32 guildId = GetGuildIdFromDB(playerguid))
         {
-            if (guild->DelMember(playerguid))
+            if (Guild* guild = sGuildMgr.GetGuildById(guildId))
             {
-                guild->Disband();
-                delete guild;
+                if (guild->DelMember(playerguid))
+                {
+                    guild->Disband();
+                    delete guild;
+                }
             }
         }
-    }
 
-    // remove from arena teams
-    LeaveAllArenaTeams(playerguid);
+        // remove from arena teams
+        LeaveAllArenaTeams(playerguid);
 
-    // the player was uninvited already on logout so just remove from group
-    auto resultGroup = CharacterDatabase.PQuery("SELECT groupId FROM group_member WHERE memberGuid='%u'", lowguid);
-    if (resultGroup)
-    {
-        uint32 groupId = (*resultGroup)[0].GetUInt32();
-        if (Group* group = sObjectMgr.GetGroupById(groupId))
-            RemoveFromGroup(group, playerguid);
+        // the player was uninvited already on logout so just remove from group
+        auto resultGroup = CharacterDatabase.PQuery("SELECT groupId FROM group_member WHERE memberGuid='%u'", lowguid);
+        if (resultGroup)
+        {
+            uint32 groupId = (*resultGroup)[0].GetUInt32();
+            if (Group* group = sObjectMgr.GetGroupById(groupId))
+                RemoveFromGroup(group, playerguid);
+        }
+
+        // remove signs from petitions (also remove petitions if owner);
+        RemovePetitionsAndSigns(playerguid, 10);
     }
 
-    // remove signs from petitions (also remove petitions if owner);
-    RemovePetitionsAndSigns(playerguid, 10);
+    SqlOrderingKey orderingKey(accountId);
 
     switch (charDelete_method)
     {
@@ -4546,6 +4566,9 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             auto resultMail = CharacterDatabase.PQuery("SELECT id,messageType,mailTemplateId,sender,subject,body,money,has_items FROM mail WHERE receiver='%u' AND has_items<>0 AND cod<>0", lowguid);
             if (resultMail)
             {
+                // returned mails go to other accounts
+                SqlOrderingKey sharedOrderingKey(0);
+
                 do
                 {
                     Field* fields = resultMail->Fetch();
@@ -7370,6 +7393,12 @@ void Player::ModifyArenaPoints(int32 value)
     SetArenaPoints(newValue);
 }
 
+void Player::SetInGuild(uint32 GuildId)
+{
+    SetUInt32Value(PLAYER_GUILDID, GuildId);
+    sWhoListIndex.UpdateGuild(this, GuildId);
+}
+
 uint32 Player::GetGuildIdFromDB(ObjectGuid guid)
 {
     uint32 lowguid = guid.GetCounter();
@@ -7541,6 +7570,9 @@ void Player::UpdateZone(uint32 newZone, uint32 newArea, bool force)
     if (updateZone || updateArea)
         GetMap()->SendZoneDynamicInfo(this, updateZone, updateArea);
 
+    if (updateZone)
+        sWhoListIndex.UpdateZone(this, newZone);
+
     m_zoneUpdateId    = newZone;
     m_zoneUpdateTimer = ZONE_UPDATE_INTERVAL;
 
@@ -16251,6 +16283,8 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
         return false;
     }
 
+    m_characterSaved = true;
+
     Field* fields = queryResult->Fetch();
 
     uint32 dbAccountId = fields[1].GetUInt32();
@@ -18135,32 +18169,44 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
+    // also autosaves from map update, keep them ordered with the requests of the session (logout, next login)
+    SqlOrderingKey orderingKey(GetSession()->GetAccountId());
+
     CharacterDatabase.BeginTransaction();
 
-    static SqlStatementID delChar ;
     static SqlStatementID insChar ;
+    static SqlStatementID updChar ;
+
+    // the row of a loaded character is updated in place, only new characters are inserted
+    SqlStatement uberInsert = m_characterSaved
+                              ? CharacterDatabase.CreateStatement(updChar, "UPDATE characters SET account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, playerBytes = ?, playerBytes2 = ?, playerFlags = ?, "
+                                "map = ?, dungeon_difficulty = ?, position_x = ?, position_y = ?, position_z = ?, orientation = ?, "
+                                "taximask = ?, online = ?, cinematic = ?, "
+                                "totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, resettalents_cost = ?, resettalents_time = ?, "
+                                "trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, extra_flags = ?, stable_slots = ?, at_login = ?, zone = ?, "
+                                "death_expire_time = ?, taxi_path = ?, arenaPoints = ?, totalHonorPoints = ?, todayHonorPoints = ?, yesterdayHonorPoints = ?, totalKills = ?, "
+                                "todayKills = ?, yesterdayKills = ?, chosenTitle = ?, knownCurrencies = ?, watchedFaction = ?, drunk = ?, health = ?, power1 = ?, power2 = ?, power3 = ?, "
+                                "power4 = ?, power5 = ?, power6 = ?, power7 = ?, specCount = ?, activeSpec = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, knownTitles = ?, actionBars = ?, grantableLevels = ?, fishingSteps = ? WHERE guid = ?")
+                              : CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+                                "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
+                                "taximask, online, cinematic, "
+                                "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
+                                "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
+                                "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
+                                "todayKills, yesterdayKills, chosenTitle, knownCurrencies, watchedFaction, drunk, health, power1, power2, power3, "
+                                "power4, power5, power6, power7, specCount, activeSpec, exploredZones, equipmentCache, ammoId, knownTitles, actionBars, grantableLevels, fishingSteps) "
+                                "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                "?, ?, ?, ?, ?, ?, "
+                                "?, ?, ?, "
+                                "?, ?, ?, ?, ?, ?, ?, "
+                                "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                "?, ?, ?, ?, ?, ?, ?, "
+                                "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
+
+    if (!m_characterSaved)
+        uberInsert.addUInt32(GetGUIDLow());
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-                              "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
-                              "taximask, online, cinematic, "
-                              "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-                              "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-                              "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
-                              "todayKills, yesterdayKills, chosenTitle, knownCurrencies, watchedFaction, drunk, health, power1, power2, power3, "
-                              "power4, power5, power6, power7, specCount, activeSpec, exploredZones, equipmentCache, ammoId, knownTitles, actionBars, grantableLevels, fishingSteps) "
-                              "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
-
-    uberInsert.addUInt32(GetGUIDLow());
     uberInsert.addUInt32(GetSession()->GetAccountId());
     uberInsert.addString(m_name);
     uberInsert.addUInt8(getRace());
@@ -18298,7 +18344,11 @@ void Player::SaveToDB()
 
     uberInsert.addUInt8(m_fishingSteps);
 
+    if (m_characterSaved)
+        uberInsert.addUInt32(GetGUIDLow());
+
     uberInsert.Execute();
+    m_characterSaved = true;
 
     if (m_mailsUpdated)                                     // save mails only when needed
         _SaveMail();
@@ -18407,6 +18457,12 @@ void Player::_SaveActions()
 
 void Player::_SaveAuras()
 {
+    // remaining durations only run down between changes, they are written at least on logout
+    if (!m_aurasChanged && !m_session->isLogingOut())
+        return;
+
+    m_aurasChanged = false;
+
     static SqlStatementID deleteAuras ;
     static SqlStatementID insertAuras ;
 
@@ -18904,6 +18960,12 @@ void Player::_SaveStats()
     if (!sWorld.getConfig(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE) || GetLevel() < sWorld.getConfig(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE))
         return;
 
+    // no stat was recalculated since the previous save
+    if (!m_statsChanged)
+        return;
+
+    m_statsChanged = false;
+
     static SqlStatementID delStats ;
     static SqlStatementID insertStats ;
 
@@ -25077,7 +25139,10 @@ void Player::ModifyCooldown(uint32 spellId, int32 cooldownModMs)
                 break; // invalidated iterator
             }
             else
+            {
                 cdData->SetSpellCDExpireTime(expireTime + std::chrono::milliseconds(cooldownModMs));
+                m_cooldownMap.SetModified();
+            }
         }
     }
 
@@ -25103,6 +25168,7 @@ void Player::ModifyCooldownTo(uint32 spellId, std::chrono::milliseconds remainin
             auto newCdExpiry = now + remainingCooldown;
             cdChange = newCdExpiry - expireTime;
             cdData->SetSpellCDExpireTime(newCdExpiry);
+            m_cooldownMap.SetModified();
             found = true;
         }
     }
@@ -25160,7 +25226,10 @@ bool Player::CanEnterNewInstance(uint32 instanceId)
 void Player::AddNewInstanceId(uint32 instanceId)
 {
     if (m_enteredInstances.find(instanceId) == m_enteredInstances.end())
+    {
         m_enteredInstances.emplace(instanceId, std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now() + std::chrono::hours(1)));
+        m_enteredInstancesChanged = true;
+    }
 }
 
 void Player::_LoadCreatedInstanceTimers()
@@ -25177,6 +25246,8 @@ void Player::_LoadCreatedInstanceTimers()
 
             if (expireTime > Clock::now())
                 m_enteredInstances.emplace(instanceId, expireTime);
+            else
+                m_enteredInstancesChanged = true;           // expired rows are removed at next save
 
         }
         while (queryResult->NextRow());
@@ -25185,6 +25256,11 @@ void Player::_LoadCreatedInstanceTimers()
 
 void Player::_SaveNewInstanceIdTimer()
 {
+    if (!m_enteredInstancesChanged)
+        return;
+
+    m_enteredInstancesChanged = false;
+
     CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
 
     if (m_enteredInstances.empty())
@@ -25209,7 +25285,10 @@ void Player::UpdateNewInstanceIdTimers(TimePoint const& now)
     for (auto iter = m_enteredInstances.begin(); iter != m_enteredInstances.end();)
     {
         if ((*iter).second < now)
+        {
             iter = m_enteredInstances.erase(iter);
+            m_enteredInstancesChanged = true;
+        }
         else
             ++iter;
     }
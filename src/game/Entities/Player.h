@@ -1592,6 +1592,8 @@ class Player : public Unit
         void SaveToDB();
         void SaveInventoryAndGoldToDB();                    // fast save function for item/money cheating preventing
         void SaveGoldToDB() const;
+        // saved sections written only when changed since the previous save
+        void SetAurasChanged() { m_aurasChanged = true; }
         static void SetUInt32ValueInArray(Tokens& tokens, uint16 index, uint32 value);
         static void Customize(ObjectGuid guid, uint8 gender, uint8 skin, uint8 face, uint8 hairStyle, uint8 hairColor, uint8 facialHair);
         static void SavePositionInDB(ObjectGuid guid, uint32 mapid, float x, float y, float z, float o, uint32 zone);
@@ -1829,7 +1831,7 @@ class Player : public Unit
         void SetAllowLowLevelRaid(bool allow) { ApplyModFlag(PLAYER_FLAGS, PLAYER_FLAGS_ENABLE_LOW_LEVEL_RAID, allow); }
         bool GetAllowLowLevelRaid() const { return HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_ENABLE_LOW_LEVEL_RAID); }
 
-        void SetInGuild(uint32 GuildId) { SetUInt32Value(PLAYER_GUILDID, GuildId); }
+        void SetInGuild(uint32 GuildId);
         void SetRank(uint32 rankId) { SetUInt32Value(PLAYER_GUILDRANK, rankId); }
         void SetGuildIdInvited(uint32 GuildId) { m_GuildIdInvited = GuildId; }
         uint32 GetGuildId() const { return GetUInt32Value(PLAYER_GUILDID);  }
@@ -2703,6 +2705,7 @@ class Player : public Unit
 
         Team m_team;
         uint32 m_nextSave;
+        bool m_characterSaved;                              // row in `characters` exists, saves update it
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
@@ -2937,6 +2940,10 @@ class Player : public Unit
         uint8 m_grantableLevels;
 
         std::unordered_map<uint32, TimePoint> m_enteredInstances;
+        bool m_enteredInstancesChanged;
+        bool m_aurasChanged;
+        bool m_statsChanged;
+        uint32 m_savedCooldownsVersion;                     // m_cooldownMap version written by the previous save
         uint32 m_createdInstanceClearTimer;
 
         uint32 m_pendingBindMapId;
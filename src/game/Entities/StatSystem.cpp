@@ -31,6 +31,8 @@
 
 bool Player::UpdateStats(Stats stat)
 {
+    m_statsChanged = true;                                  // saved to character_stats
+
     if (stat > STAT_SPIRIT)
         return false;
 
@@ -93,6 +95,8 @@ bool Player::UpdateStats(Stats stat)
 
 void Player::ApplySpellPowerBonus(int32 amount, bool apply)
 {
+    m_statsChanged = true;
+
     m_baseSpellPower += apply ? amount : -amount;
 
     // For speed just update for client
@@ -123,6 +127,8 @@ void Player::UpdateSpellDamageBonus()
 
 bool Player::UpdateAllStats()
 {
+    m_statsChanged = true;
+
     for (int i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         float value = GetTotalStatValue(Stats(i));
@@ -159,6 +165,8 @@ bool Player::UpdateAllStats()
 
 void Player::UpdateResistances(uint32 school)
 {
+    m_statsChanged = true;
+
     if (school > SPELL_SCHOOL_NORMAL)
     {
         int32 value = GetTotalResistanceValue(SpellSchools(school));
@@ -175,6 +183,8 @@ void Player::UpdateResistances(uint32 school)
 
 void Player::UpdateArmor()
 {
+    m_statsChanged = true;
+
     float dynamic = (GetStat(STAT_AGILITY) * 2.0f);
 
     // Add dynamic flat mods
@@ -222,6 +232,8 @@ float Player::GetManaBonusFromIntellect() const
 
 void Player::UpdateMaxHealth()
 {
+    m_statsChanged = true;
+
     UnitMods unitMod = UNIT_MOD_HEALTH;
 
     float value = GetModifierValue(unitMod, BASE_VALUE) + GetCreateHealth();
@@ -234,6 +246,8 @@ void Player::UpdateMaxHealth()
 
 void Player::UpdateMaxPower(Powers power)
 {
+    m_statsChanged = true;
+
     UnitMods unitMod = UnitMods(UNIT_MOD_POWER_START + power);
 
     uint32 create_power = GetCreatePowers(power);
@@ -257,6 +271,8 @@ void Player::ApplyFeralAPBonus(int32 amount, bool apply)
 
 void Player::UpdateAttackPowerAndDamage(bool ranged)
 {
+    m_statsChanged = true;
+
     float val2 = 0.0f;
     float level = float(GetLevel());
 
@@ -503,6 +519,8 @@ void Player::UpdateDefenseBonusesMod()
 
 void Player::UpdateBlockPercentage()
 {
+    m_statsChanged = true;
+
     float value = 0.0f;
     float real = 0.0f;
     if (CanBlock())
@@ -523,6 +541,8 @@ void Player::UpdateBlockPercentage()
 
 void Player::UpdateCritPercentage(WeaponAttackType attType)
 {
+    m_statsChanged = true;
+
     BaseModGroup modGroup;
     uint16 index;
     CombatRating cr;
@@ -569,6 +589,8 @@ void Player::UpdateAllCritPercentages()
 
 void Player::UpdateParryPercentage()
 {
+    m_statsChanged = true;
+
     float value = 0.0f;
     float real = 0.0f;
     if (CanParry())
@@ -609,6 +631,8 @@ static const float PLAYER_BASE_DODGE[MAX_CLASSES] =
 
 void Player::UpdateDodgePercentage()
 {
+    m_statsChanged = true;
+
     // Base dodge
     float value = (getClass() < MAX_CLASSES) ? PLAYER_BASE_DODGE[getClass()] : 0.0f;
     // Dodge from agility
@@ -629,6 +653,8 @@ void Player::UpdateDodgePercentage()
 
 void Player::UpdateSpellCritChance(uint32 school)
 {
+    m_statsChanged = true;
+
     float crit = 0.0f;
     // Base spell crit and spell crit from Intellect
     crit += GetSpellCritFromIntellect();
@@ -31,6 +31,7 @@
 #include "Groups/Group.h"
 #include "Spells/SpellAuras.h"
 #include "Globals/ObjectAccessor.h"
+#include "Globals/WhoListIndex.h"
 #include "AI/CreatureAISelector.h"
 #include "Entities/TemporarySpawn.h"
 #include "Entities/Pet.h"
@@ -293,6 +294,8 @@ Unit::Unit() :
     // m_AurasCheck = 2000;
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    memset(m_procAuraHolderCount, 0, sizeof(m_procAuraHolderCount));
+    m_procAuraFlags = 0;
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
@@ -435,6 +438,7 @@ void Unit::Update(const uint32 diff)
     m_spellUpdateHappening = false;
 
     CleanupDeletedAuras();
+    UpdateAuraModifierTotals();
 
     if (m_lastManaUseTimer)
     {
@@ -531,6 +535,8 @@ void Unit::TriggerAggroLinkingEvent(Unit* enemy)
 
 void Unit::TriggerEvadeEvents()
 {
+    auto scriptGuard = GetMap()->GetScriptGuard();
+
     static_cast<Creature*>(this)->SetLootRecipient(nullptr);
 
     if (InstanceData* mapInstance = GetInstanceData())
@@ -1391,6 +1397,8 @@ void Unit::JustKilledCreature(Unit* killer, Creature* victim, Player* responsibl
     }
 
     /* ******************************* Inform various hooks ************************************ */
+    auto scriptGuard = victim->GetMap()->GetScriptGuard();
+
     // Inform victim's AI
     if (victim->AI())
         victim->AI()->JustDied(killer);
@@ -2587,6 +2595,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
             if (dropCharge)
                 if ((*i)->GetHolder()->DropAuraCharge())
                     mod->m_amount = 0;
+            InvalidateAuraModifierTotals(mod->m_auraname);
             // Need remove it later
             if (mod->m_amount <= 0)
                 existExpired = true;
@@ -2651,6 +2660,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
         (*i)->OnManaAbsorb(currentAbsorb);
 
         (*i)->GetModifier()->m_amount -= currentAbsorb;
+        InvalidateAuraModifierTotals(SPELL_AURA_MANA_SHIELD);
         if ((*i)->GetModifier()->m_amount <= 0)
         {
             RemoveAurasDueToSpell((*i)->GetId());
@@ -2825,6 +2835,7 @@ void Unit::CalculateHealAbsorb(const uint32 heal, uint32* absorb)
         mod->m_amount -= currentAbsorb;
         if ((*i)->GetHolder()->DropAuraCharge())
             mod->m_amount = 0;
+        InvalidateAuraModifierTotals(mod->m_auraname);
         // Need remove it later
         if (mod->m_amount <= 0)
             existExpired = true;
@@ -5059,15 +5070,61 @@ void Unit::DeMorph()
     SetDisplayId(GetNativeDisplayId());
 }
 
-int32 Unit::GetTotalAuraModifier(AuraType auratype) const
+Unit::AuraModifierTotals Unit::GetAuraModifierTotals(AuraType auratype) const
 {
-    int32 modifier = 0;
+    auto itr = m_auraModifierTotals.find(auratype);
+    if (itr != m_auraModifierTotals.end())
+        return itr->second;
 
+    return CalculateAuraModifierTotals(auratype);
+}
+
+Unit::AuraModifierTotals Unit::CalculateAuraModifierTotals(AuraType auratype) const
+{
+    AuraModifierTotals totals = { 0, 1.0f, 0, 0 };
+    for (auto i : GetAurasByType(auratype))
+    {
+        int32 amount = i->GetModifier()->m_amount;
+        totals.total += amount;
+        totals.multiplier *= (100.0f + amount) / 100.0f;
+        if (amount > totals.maxPositive)
+            totals.maxPositive = amount;
+        if (amount < totals.maxNegative)
+            totals.maxNegative = amount;
+    }
+
+    return totals;
+}
+
+void Unit::InvalidateAuraModifierTotals(AuraType auratype)
+{
+    m_auraModifierTotals.erase(auratype);
+    m_staleAuraModifierTotals.insert(auratype);
+
+    // aura amounts are saved with the character
+    if (GetTypeId() == TYPEID_PLAYER)
+        static_cast<Player*>(this)->SetAurasChanged();
+}
+
+void Unit::UpdateAuraModifierTotals()
+{
+    for (uint32 auratype : m_staleAuraModifierTotals)
+        if (GetAurasByType(AuraType(auratype)).size() > 1)
+            m_auraModifierTotals[auratype] = CalculateAuraModifierTotals(AuraType(auratype));
+
+    m_staleAuraModifierTotals.clear();
+}
+
+int32 Unit::GetTotalAuraModifier(AuraType auratype) const
+{
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        modifier += i->GetModifier()->m_amount;
+    if (mTotalAuraList.empty())
+        return 0;
 
-    return modifier;
+    if (mTotalAuraList.size() == 1)
+        return mTotalAuraList.front()->GetModifier()->m_amount;
+
+    return GetAuraModifierTotals(auratype).total;
 }
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype, std::function<bool(Aura const*)> predicate) const
@@ -5084,37 +5141,38 @@ int32 Unit::GetTotalAuraModifier(AuraType auratype, std::function<bool(Aura cons
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    float multiplier = 1.0f;
-
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        multiplier *= (100.0f + i->GetModifier()->m_amount) / 100.0f;
+    if (mTotalAuraList.empty())
+        return 1.0f;
 
-    return multiplier;
+    if (mTotalAuraList.size() == 1)
+        return (100.0f + mTotalAuraList.front()->GetModifier()->m_amount) / 100.0f;
+
+    return GetAuraModifierTotals(auratype).multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        if (i->GetModifier()->m_amount > modifier)
-            modifier = i->GetModifier()->m_amount;
+    if (mTotalAuraList.empty())
+        return 0;
 
-    return modifier;
+    if (mTotalAuraList.size() == 1)
+        return std::max(mTotalAuraList.front()->GetModifier()->m_amount, 0);
+
+    return GetAuraModifierTotals(auratype).maxPositive;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        if (i->GetModifier()->m_amount < modifier)
-            modifier = i->GetModifier()->m_amount;
+    if (mTotalAuraList.empty())
+        return 0;
 
-    return modifier;
+    if (mTotalAuraList.size() == 1)
+        return std::min(mTotalAuraList.front()->GetModifier()->m_amount, 0);
+
+    return GetAuraModifierTotals(auratype).maxNegative;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -5266,6 +5324,9 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
 {
     SpellEntry const* aurSpellInfo = holder->GetSpellProto();
 
+    if (GetTypeId() == TYPEID_PLAYER)
+        static_cast<Player*>(this)->SetAurasChanged();
+
     // ghost spell check, allow apply any auras at player loading in ghost mode (will be cleanup after load)
     if (!IsAlive() && !IsDeathPersistentSpell(aurSpellInfo) &&
             !IsDeathOnlySpell(aurSpellInfo) && !aurSpellInfo->HasAttribute(SPELL_ATTR_EX2_ALLOW_DEAD_TARGET) &&
@@ -5452,6 +5513,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->_AddSpellAuraHolder();
     holder->SetCreationDelayFlag();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    UpdateProcAuraHolders(holder, true);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -5476,7 +5538,10 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
 void Unit::AddAuraToModList(Aura* aura)
 {
     if (aura->GetModifier()->m_auraname < TOTAL_AURAS)
+    {
         m_modAuras[aura->GetModifier()->m_auraname].push_back(aura);
+        InvalidateAuraModifierTotals(aura->GetModifier()->m_auraname);
+    }
 }
 
 void Unit::RemoveRankAurasDueToSpell(uint32 spellId)
@@ -6071,6 +6136,9 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
 {
     MANGOS_ASSERT(!holder->IsDeleted());
 
+    if (GetTypeId() == TYPEID_PLAYER)
+        static_cast<Player*>(this)->SetAurasChanged();
+
     // Statue unsummoned at holder remove
     SpellEntry const* aurSpellInfo = holder->GetSpellProto();
     Totem* statue = nullptr;
@@ -6088,6 +6156,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         if (itr->second == holder)
         {
             m_spellAuraHolders.erase(itr);
+            UpdateProcAuraHolders(holder, false);
             break;
         }
     }
@@ -6154,6 +6223,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        InvalidateAuraModifierTotals(Aur->GetModifier()->m_auraname);
     }
 
     // Set remove mode
@@ -8991,6 +9061,7 @@ void Unit::SetInCombatState(bool PvP, Unit* enemy)
 
     if (creatureNotInCombat)
     {
+        auto scriptGuard = GetMap()->GetScriptGuard();
         Creature* creature = static_cast<Creature*>(this);
 
         m_damageByOthers = 0;
@@ -9349,6 +9420,7 @@ void Unit::UpdateVisibilityAndView()
             if (!owner || !IsVisibleForOrDetect(owner, this, false))
             {
                 alist.erase(it);
+                InvalidateAuraModifierTotals(*type);
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -10346,9 +10418,14 @@ void Unit::SetLevel(uint32 lvl)
 {
     SetUInt32Value(UNIT_FIELD_LEVEL, lvl);
 
-    // group update
-    if ((GetTypeId() == TYPEID_PLAYER) && ((Player*)this)->GetGroup())
-        ((Player*)this)->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        // group update
+        if (((Player*)this)->GetGroup())
+            ((Player*)this)->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
+
+        sWhoListIndex.UpdateLevel((Player*)this, lvl);
+    }
 }
 
 void Unit::SetHealth(float val)
@@ -12243,10 +12320,10 @@ bool Unit::IsAllowedDamageInArea(Unit* attacker, Unit* pVictim)
     return !(area && area->flags & AREA_FLAG_SANCTUARY);
 }
 
-class UnitVisitObjectsInRangeNotifyEvent : public BasicEvent
+class UnitVisitObjectsInRangeNotifyEvent : public PooledEvent<UnitVisitObjectsInRangeNotifyEvent>
 {
     public:
-        UnitVisitObjectsInRangeNotifyEvent(Unit& owner) : BasicEvent(), m_owner(owner) {}
+        UnitVisitObjectsInRangeNotifyEvent(Unit& owner) : m_owner(owner) {}
 
         bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
         {
@@ -12284,9 +12361,9 @@ void Unit::ScheduleAINotify(uint32 delay, bool forced)
         m_AINotifyEvent = new UnitVisitObjectsInRangeNotifyEvent(*this);
         m_events.AddEvent(m_AINotifyEvent, m_events.CalculateTime(delay));
     }
-    else if (forced)
+    else if (forced && !m_events.ModifyEventTime(m_AINotifyEvent, m_events.CalculateTime(delay)))
     {
-        m_events.KillEvent(m_AINotifyEvent);
+        // currently executing
         m_AINotifyEvent = new UnitVisitObjectsInRangeNotifyEvent(*this);
         m_events.AddEvent(m_AINotifyEvent, m_events.CalculateTime(delay));
     }
@@ -13223,8 +13300,9 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
+        EventList events = target->m_events.GetEvents();
+        for (BasicEvent* queuedEvent : events)
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(queuedEvent))
                 if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
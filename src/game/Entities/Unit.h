@@ -2256,6 +2256,9 @@ class Unit : public WorldObject
         // misc have plain value but we check it fit to provided values mask (mask & (1 << (misc-1)))
         float GetTotalAuraMultiplierByMiscValueForMask(AuraType auratype, uint32 mask) const;
 
+        // must be called whenever an aura of this type is added, removed or has its amount changed
+        void InvalidateAuraModifierTotals(AuraType auratype);
+
         Aura* GetDummyAura(uint32 spell_id) const;
 
         uint32 m_AuraFlags;
@@ -2315,6 +2318,7 @@ class Unit : public WorldObject
         };
 
         SpellProcEventTriggerCheck IsTriggeredAtSpellProcEvent(ProcExecutionData& data, SpellAuraHolder* holder, SpellProcEventEntry const*& spellProcEvent);
+        void UpdateProcAuraHolders(SpellAuraHolder* holder, bool add);
         // only to be used in proc handlers - basepoints is expected to be a MAX_EFFECT_INDEX sized array
         SpellAuraProcResult TriggerProccedSpell(Unit* target, std::array<int32, MAX_EFFECT_INDEX>& basepoints, uint32 triggeredSpellId, Item* castItem, Aura* triggeredByAura, uint32 cooldown, ObjectGuid originalCaster);
         SpellAuraProcResult TriggerProccedSpell(Unit* target, std::array<int32, MAX_EFFECT_INDEX>& basepoints, SpellEntry const* spellInfo, Item* castItem, Aura* triggeredByAura, uint32 cooldown, ObjectGuid originalCaster);
@@ -2663,6 +2667,9 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
+        SpellAuraHolderMap m_procAuraHolders;               // holders of m_spellAuraHolders which have proc flags
+        uint32 m_procAuraHolderCount[32];                   // holders in m_procAuraHolders per proc flag bit
+        uint32 m_procAuraFlags;                             // proc flag bits with at least one holder
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
         std::map<uint32, Aura*> m_classScripts;
@@ -2683,6 +2690,21 @@ class Unit : public WorldObject
         std::map<uint32, Creature*> m_creatures;
 
         AuraList m_modAuras[TOTAL_AURAS];
+
+        // unfiltered aggregates of m_modAuras, kept only for types with more than one aura
+        // filled only by the owner's Update, const getters compute missing totals without storing them
+        struct AuraModifierTotals
+        {
+            int32 total;
+            float multiplier;
+            int32 maxPositive;
+            int32 maxNegative;
+        };
+        AuraModifierTotals GetAuraModifierTotals(AuraType auratype) const;
+        AuraModifierTotals CalculateAuraModifierTotals(AuraType auratype) const;
+        void UpdateAuraModifierTotals();
+        std::unordered_map<uint32, AuraModifierTotals> m_auraModifierTotals;
+        std::unordered_set<uint32> m_staleAuraModifierTotals;
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
 
         WeaponDamageInfo m_weaponDamageInfo;
@@ -60,29 +60,75 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     }
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+namespace
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+    // deflate state of one thread, initializing it allocates a few hundred KB so it is only reset between packets
+    class UpdateCompressor
+    {
+        public:
+            UpdateCompressor() : m_initialized(false), m_level(0) {}
+            ~UpdateCompressor()
+            {
+                if (m_initialized)
+                    deflateEnd(&m_stream);
+            }
+
+            z_stream* Acquire(int level)
+            {
+                if (m_initialized && level == m_level)
+                {
+                    int z_res = deflateReset(&m_stream);
+                    if (z_res == Z_OK)
+                        return &m_stream;
+
+                    sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+                }
+
+                // first use or compression level changed by config reload
+                if (m_initialized)
+                    deflateEnd(&m_stream);
+
+                m_stream.zalloc = (alloc_func)nullptr;
+                m_stream.zfree = (free_func)nullptr;
+                m_stream.opaque = (voidpf)nullptr;
+
+                int z_res = deflateInit(&m_stream, level);
+                m_initialized = z_res == Z_OK;
+                m_level = level;
+                if (!m_initialized)
+                {
+                    sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                    return nullptr;
+                }
+
+                return &m_stream;
+            }
+
+        private:
+            z_stream m_stream;
+            bool m_initialized;
+            int m_level;
+    };
+
+    thread_local UpdateCompressor t_updateCompressor;
+}
 
+void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+{
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = t_updateCompressor.Acquire(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -90,14 +136,14 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -105,58 +151,46 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 WorldPacket UpdateData::BuildPacket(size_t index)
 {
-    WorldPacket packet;
-    MANGOS_ASSERT(packet.empty());                         // shouldn't happen
-
-    ByteBuffer buf(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data[index].m_buffer.wpos());
+    // built straight into the packet, only large packets need a second buffer for the compressed data
+    WorldPacket packet(SMSG_UPDATE_OBJECT, 4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data[index].m_buffer.wpos());
 
-    buf << (uint32)(!m_outOfRangeGUIDs.empty() ? m_data[index].m_blockCount + 1 : m_data[index].m_blockCount);
+    packet << (uint32)(!m_outOfRangeGUIDs.empty() ? m_data[index].m_blockCount + 1 : m_data[index].m_blockCount);
 
     if (!m_outOfRangeGUIDs.empty())
     {
-        buf << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
-        buf << (uint32) m_outOfRangeGUIDs.size();
+        packet << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
+        packet << (uint32) m_outOfRangeGUIDs.size();
 
         for (auto m_outOfRangeGUID : m_outOfRangeGUIDs)
-            buf << m_outOfRangeGUID.WriteAsPacked();
+            packet << m_outOfRangeGUID.WriteAsPacked();
     }
 
-    buf.append(m_data[index].m_buffer);
+    packet.append(m_data[index].m_buffer);
 
-    size_t pSize = buf.wpos();                              // use real used data size
+    size_t pSize = packet.wpos();                           // use real used data size
 
-    if (pSize > 100)                                        // compress large packets
+    if (pSize > sWorld.getConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD))  // compress large packets
     {
+        WorldPacket compressed;
         uint32 destsize = compressBound(pSize);
-        packet.resize(destsize + sizeof(uint32));
+        compressed.resize(destsize + sizeof(uint32));
 
-        packet.put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet.contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
+        compressed.put<uint32>(0, pSize);
+        Compress(const_cast<uint8*>(compressed.contents()) + sizeof(uint32), &destsize, (void*)packet.contents(), pSize);
         if (destsize == 0)
-            return packet;
+            return compressed;
 
-        packet.resize(destsize + sizeof(uint32));
-        packet.SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
-    }
-    else                                                    // send small packets without compression
-    {
-        packet.append(buf);
-        packet.SetOpcode(SMSG_UPDATE_OBJECT);
+        compressed.resize(destsize + sizeof(uint32));
+        compressed.SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
+        return compressed;
     }
 
+    // send small packets without compression
     return packet;
 }
 
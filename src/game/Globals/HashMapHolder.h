@@ -0,0 +1,108 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_HASHMAPHOLDER_H
+#define MANGOS_HASHMAPHOLDER_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+
+// Guid lookup split into shards by guid counter, each behind its own reader/writer lock,
+// so lookups from different map threads neither wait for each other nor for unrelated inserts
+template <class T>
+class HashMapHolder
+{
+    public:
+
+        typedef std::unordered_map<ObjectGuid, T*>   MapType;
+        typedef std::shared_mutex LockType;
+        typedef std::shared_lock<LockType> ReadGuard;
+        typedef std::unique_lock<LockType> WriteGuard;
+
+        static void Insert(T* o);
+
+        static void Remove(T* o);
+
+        static T* Find(ObjectGuid guid);
+
+        // Calls executor for every object, read locking one shard at a time.
+        // Executor must not insert or remove objects of this holder.
+        static void DoForAll(std::function<void(T*)> const& executor);
+
+    private:
+
+        // Non instanceable only static
+        HashMapHolder() {}
+
+        static uint32 const SHARD_COUNT = 16;
+
+        struct alignas(64) Shard
+        {
+            LockType i_lock;
+            MapType  m_objectMap;
+        };
+
+        static Shard& GetShard(ObjectGuid guid) { return m_shards[guid.GetCounter() % SHARD_COUNT]; }
+
+        static Shard m_shards[SHARD_COUNT];
+};
+
+template<class T>
+void HashMapHolder<T>::Insert(T* o)
+{
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.i_lock);
+    shard.m_objectMap[o->GetObjectGuid()] = o;
+}
+
+template<class T>
+void HashMapHolder<T>::Remove(T* o)
+{
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.i_lock);
+    shard.m_objectMap.erase(o->GetObjectGuid());
+}
+
+template<class T>
+T* HashMapHolder<T>::Find(ObjectGuid guid)
+{
+    Shard& shard = GetShard(guid);
+    ReadGuard guard(shard.i_lock);
+    typename MapType::iterator itr = shard.m_objectMap.find(guid);
+    return (itr != shard.m_objectMap.end()) ? itr->second : nullptr;
+}
+
+template<class T>
+void HashMapHolder<T>::DoForAll(std::function<void(T*)> const& executor)
+{
+    for (Shard& shard : m_shards)
+    {
+        ReadGuard guard(shard.i_lock);
+        for (auto& itr : shard.m_objectMap)
+            executor(itr.second);
+    }
+}
+
+template <class T> typename HashMapHolder<T>::Shard HashMapHolder<T>::m_shards[HashMapHolder<T>::SHARD_COUNT];
+
+#endif
@@ -18,6 +18,7 @@
 
 #include "Globals/ObjectAccessor.h"
 #include "Globals/ObjectMgr.h"
+#include "Globals/WhoListIndex.h"
 #include "Policies/Singleton.h"
 #include "Entities/Player.h"
 #include "Entities/Item.h"
@@ -35,34 +36,6 @@
 INSTANTIATE_SINGLETON_2(ObjectAccessor, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(ObjectAccessor, std::mutex);
 
-template<class T>
-void HashMapHolder<T>::Insert(T* o)
-{
-    WriteGuard guard(i_lock);
-    m_objectMap[o->GetObjectGuid()] = o;
-}
-
-template<class T>
-void HashMapHolder<T>::Remove(T* o)
-{
-    WriteGuard guard(i_lock);
-    m_objectMap.erase(o->GetObjectGuid());
-}
-
-template<class T>
-T* HashMapHolder<T>::Find(ObjectGuid guid)
-{
-    ReadGuard guard(i_lock);
-    typename MapType::iterator itr = m_objectMap.find(guid);
-    return (itr != m_objectMap.end()) ? itr->second : nullptr;
-}
-
-template<class T>
-typename HashMapHolder<T>::MapType& HashMapHolder<T>::GetContainer() { return m_objectMap; }
-
-template<class T>
-typename HashMapHolder<T>::LockType& HashMapHolder<T>::GetLock() { return i_lock; }
-
 ObjectAccessor::ObjectAccessor() {}
 ObjectAccessor::~ObjectAccessor()
 {
@@ -122,27 +95,22 @@ Player* ObjectAccessor::FindPlayerByName(char const* name, bool inWorld /*=true*
 
 void ObjectAccessor::SaveAllPlayers() const
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (auto& itr : m)
+    HashMapHolder<Player>::DoForAll([](Player* player)
     {
-        if (itr.second->IsInWorld())
-            itr.second->GetMap()->GetMessager().AddMessage([guid = itr.second->GetObjectGuid()](Map* map)
+        if (player->IsInWorld())
+            player->GetMap()->GetMessager().AddMessage([guid = player->GetObjectGuid()](Map* map)
             {
-                if (Player* player = map->GetPlayer(guid))
-                    player->SaveToDB();
+                if (Player* mapPlayer = map->GetPlayer(guid))
+                    mapPlayer->SaveToDB();
             });
         else
-            itr.second->SaveToDB();
-    }
+            player->SaveToDB();
+    });
 }
 
 void ObjectAccessor::ExecuteOnAllPlayers(std::function<void(Player*)> executor)
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        executor(itr->second);
+    HashMapHolder<Player>::DoForAll(executor);
 }
 
 void ObjectAccessor::KickPlayer(ObjectGuid guid)
@@ -312,19 +280,16 @@ void ObjectAccessor::AddObject(Player* player)
 {
     HashMapHolder<Player>::Insert(player);
     PlayerNameMapHolder::Insert(player);
+    sWhoListIndex.AddPlayer(player);
 }
 
 void ObjectAccessor::RemoveObject(Player* player)
 {
+    sWhoListIndex.RemovePlayer(player);
     HashMapHolder<Player>::Remove(player);
     PlayerNameMapHolder::Remove(player);
 }
 
-/// Define the static member of HashMapHolder
-
-template <class T> typename HashMapHolder<T>::MapType HashMapHolder<T>::m_objectMap;
-template <class T> std::mutex HashMapHolder<T>::i_lock;
-
 /// Global definitions for the hashmap storage
 
 template class HashMapHolder<Player>;
@@ -30,6 +30,7 @@
 #include "Entities/Object.h"
 #include "Entities/Player.h"
 #include "Entities/Corpse.h"
+#include "Globals/HashMapHolder.h"
 
 #include <functional>
 #include <mutex>
@@ -38,34 +39,8 @@ class Unit;
 class WorldObject;
 class Map;
 
-template <class T>
-class HashMapHolder
-{
-    public:
-
-        typedef std::unordered_map<ObjectGuid, T*>   MapType;
-        typedef std::mutex LockType;
-        typedef std::lock_guard<std::mutex> ReadGuard;
-        typedef std::lock_guard<std::mutex> WriteGuard;
-
-        static void Insert(T* o);
-
-        static void Remove(T* o);
-
-        static T* Find(ObjectGuid guid);
-
-        static MapType& GetContainer();
-
-        static LockType& GetLock();
-
-    private:
-
-        // Non instanceable only static
-        HashMapHolder() {}
-
-        static LockType i_lock;
-        static MapType  m_objectMap;
-};
+extern template class HashMapHolder<Player>;
+extern template class HashMapHolder<Corpse>;
 
 class PlayerNameMapHolder
 {
@@ -101,15 +76,13 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         static Unit* GetUnit(WorldObject const& u, ObjectGuid guid);
 
         // Player access
+        // Returned players are deleted on logout by WorldSession::LogoutPlayer (Map::Remove or Map::DeleteFromWorld)
+        // right after removal from here, during the world thread's session update while no map is updated.
+        // The pointer is valid until the end of the current map update or the next session update: keep the guid, not the pointer
         static Player* FindPlayer(ObjectGuid guid, bool inWorld = true);// if need player at specific map better use Map::GetPlayer
         static Player* FindPlayerByName(char const* name, bool inWorld = true);
         static void KickPlayer(ObjectGuid guid);
 
-        HashMapHolder<Player>::MapType& GetPlayers() const
-        {
-            return HashMapHolder<Player>::GetContainer();
-        }
-
         void SaveAllPlayers() const;
         void ExecuteOnAllPlayers(std::function<void(Player*)> executor);
 
@@ -0,0 +1,300 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Globals/WhoListIndex.h"
+#include "Policies/Singleton.h"
+#include "Entities/Player.h"
+#include "Guilds/GuildMgr.h"
+#include "Server/DBCStores.h"
+#include "Server/WorldSession.h"
+#include "Util/Util.h"
+
+INSTANTIATE_SINGLETON_1(WhoListIndex);
+
+static std::wstring ToLowerWStr(std::string const& str)
+{
+    std::wstring wstr;
+    if (!Utf8toWStr(str, wstr))
+        return std::wstring();
+
+    wstrToLower(wstr);
+    return wstr;
+}
+
+WhoListIndex::WhoListIndex()
+{
+    for (auto& levelIndex : m_levelIndex)
+        levelIndex.resize(STRONG_MAX_LEVEL + 1);
+}
+
+void WhoListIndex::AddPlayer(Player* player)
+{
+    WhoListEntry entry;
+    entry.player = player;
+    entry.name = player->GetName();
+    entry.lowerName = ToLowerWStr(entry.name);
+    entry.guildId = player->GetGuildId();
+    entry.guildName = sGuildMgr.GetGuildNameById(entry.guildId);
+    entry.lowerGuildName = ToLowerWStr(entry.guildName);
+    entry.level = std::min(player->GetLevel(), uint32(STRONG_MAX_LEVEL));
+    entry.zoneId = player->GetCachedZoneId();
+    entry.teamIndex = GetTeamIndexByTeamId(player->GetTeam());
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_entries.find(player->GetObjectGuid());
+    if (itr != m_entries.end())
+    {
+        Unlink(&itr->second);
+        itr->second = std::move(entry);
+    }
+    else
+        itr = m_entries.emplace(player->GetObjectGuid(), std::move(entry)).first;
+
+    Link(&itr->second);
+}
+
+void WhoListIndex::RemovePlayer(Player* player)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_entries.find(player->GetObjectGuid());
+    if (itr == m_entries.end() || itr->second.player != player)
+        return;
+
+    Unlink(&itr->second);
+    m_entries.erase(itr);
+}
+
+void WhoListIndex::UpdateLevel(Player* player, uint32 level)
+{
+    level = std::min(level, uint32(STRONG_MAX_LEVEL));
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_entries.find(player->GetObjectGuid());
+    if (itr == m_entries.end() || itr->second.level == level)
+        return;
+
+    WhoListEntry* entry = &itr->second;
+    m_levelIndex[entry->teamIndex][entry->level].erase(entry);
+    entry->level = level;
+    m_levelIndex[entry->teamIndex][entry->level].insert(entry);
+}
+
+void WhoListIndex::UpdateZone(Player* player, uint32 zoneId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_entries.find(player->GetObjectGuid());
+    if (itr == m_entries.end() || itr->second.zoneId == zoneId)
+        return;
+
+    WhoListEntry* entry = &itr->second;
+    ZoneIndex& zoneIndex = m_zoneIndex[entry->teamIndex];
+    auto zoneItr = zoneIndex.find(entry->zoneId);
+    if (zoneItr != zoneIndex.end())
+    {
+        zoneItr->second.erase(entry);
+        if (zoneItr->second.empty())
+            zoneIndex.erase(zoneItr);
+    }
+    entry->zoneId = zoneId;
+    zoneIndex[entry->zoneId].insert(entry);
+}
+
+void WhoListIndex::UpdateGuild(Player* player, uint32 guildId)
+{
+    std::string guildName = sGuildMgr.GetGuildNameById(guildId);
+    std::wstring lowerGuildName = ToLowerWStr(guildName);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_entries.find(player->GetObjectGuid());
+    if (itr == m_entries.end())
+        return;
+
+    itr->second.guildId = guildId;
+    itr->second.guildName = std::move(guildName);
+    itr->second.lowerGuildName = std::move(lowerGuildName);
+}
+
+void WhoListIndex::Link(WhoListEntry* entry)
+{
+    m_nameIndex[entry->teamIndex][entry->lowerName] = entry;
+    m_zoneIndex[entry->teamIndex][entry->zoneId].insert(entry);
+    m_levelIndex[entry->teamIndex][entry->level].insert(entry);
+
+    if (entry->player->GetSession()->GetSecurity() > SEC_PLAYER)
+        m_staff.insert(entry);
+}
+
+void WhoListIndex::Unlink(WhoListEntry* entry)
+{
+    NameIndex& nameIndex = m_nameIndex[entry->teamIndex];
+    auto nameItr = nameIndex.find(entry->lowerName);
+    if (nameItr != nameIndex.end() && nameItr->second == entry)
+        nameIndex.erase(nameItr);
+
+    ZoneIndex& zoneIndex = m_zoneIndex[entry->teamIndex];
+    auto zoneItr = zoneIndex.find(entry->zoneId);
+    if (zoneItr != zoneIndex.end())
+    {
+        zoneItr->second.erase(entry);
+        if (zoneItr->second.empty())
+            zoneIndex.erase(zoneItr);
+    }
+
+    m_levelIndex[entry->teamIndex][entry->level].erase(entry);
+    m_staff.erase(entry);
+}
+
+void WhoListIndex::DoForStaff(std::function<void(Player*)> const& executor) const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for (WhoListEntry const* entry : m_staff)
+        executor(entry->player);
+}
+
+bool WhoListIndex::Matches(WhoListQuery const& query, WhoListEntry const* entry) const
+{
+    Player* player = entry->player;
+
+    // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
+    if (query.hideGameMasters && player->GetSession()->GetSecurity() > query.maxSecurity)
+        return false;
+
+    // do not process players which are not in world
+    if (!player->IsInWorld())
+        return false;
+
+    // check if target is globally visible for player
+    if (!player->IsVisibleGloballyFor(query.searcher))
+        return false;
+
+    if (entry->level < query.levelMin || entry->level > query.levelMax)
+        return false;
+
+    if (!(query.classMask & (1 << player->getClass())))
+        return false;
+
+    if (!(query.raceMask & (1 << player->getRace())))
+        return false;
+
+    if (!query.zoneIds.empty() && std::find(query.zoneIds.begin(), query.zoneIds.end(), entry->zoneId) == query.zoneIds.end())
+        return false;
+
+    if (!query.playerName.empty() && entry->lowerName.find(query.playerName) == std::wstring::npos)
+        return false;
+
+    if (!query.guildName.empty() && entry->lowerGuildName.find(query.guildName) == std::wstring::npos)
+        return false;
+
+    if (query.strings.empty())
+        return true;
+
+    std::string areaName;
+    if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(entry->zoneId))
+        areaName = areaEntry->area_name[query.locale];
+
+    for (std::wstring const& str : query.strings)
+        if (entry->lowerGuildName.find(str) != std::wstring::npos ||
+                entry->lowerName.find(str) != std::wstring::npos ||
+                Utf8FitTo(areaName, str))
+            return true;
+
+    return false;
+}
+
+uint32 WhoListIndex::Query(WhoListQuery const& query, std::vector<WhoListResult>& result, uint32 maxResults, uint32 maxCount) const
+{
+    uint32 matchCount = 0;
+
+    // returns false once the result is full and enough matches are counted
+    auto visit = [&](WhoListEntry const* entry)
+    {
+        if (!Matches(query, entry))
+            return true;
+
+        ++matchCount;
+        if (result.size() < maxResults)
+        {
+            Player* player = entry->player;
+            result.push_back({ entry->name, entry->guildName, entry->level, player->getClass(), player->getRace(), player->getGender(), entry->zoneId });
+        }
+
+        return result.size() < maxResults || !maxCount || matchCount < maxCount;
+    };
+
+    PvpTeamIndex searcherTeamIndex = GetTeamIndexByTeamId(query.searcher->GetTeam());
+    uint32 levelMax = std::min(query.levelMax, uint32(STRONG_MAX_LEVEL));
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for (uint32 teamIndex = 0; teamIndex < PVP_TEAM_COUNT; ++teamIndex)
+    {
+        if (!query.allTeams && teamIndex != uint32(searcherTeamIndex))
+            continue;
+
+        // pick the narrowest bucket the query allows, Matches() checks the remaining criteria
+        if (!query.zoneIds.empty())
+        {
+            ZoneIndex const& zoneIndex = m_zoneIndex[teamIndex];
+            for (uint32 zoneId : query.zoneIds)
+            {
+                auto zoneItr = zoneIndex.find(zoneId);
+                if (zoneItr == zoneIndex.end())
+                    continue;
+
+                for (WhoListEntry const* entry : zoneItr->second)
+                    if (!visit(entry))
+                        return matchCount;
+            }
+        }
+        else if (!query.playerName.empty())
+        {
+            // names starting with the searched one first, then the remaining ones for substring matches
+            NameIndex const& nameIndex = m_nameIndex[teamIndex];
+            NameIndex::const_iterator prefixBegin = nameIndex.lower_bound(query.playerName);
+            NameIndex::const_iterator prefixEnd = prefixBegin;
+            for (; prefixEnd != nameIndex.end() && prefixEnd->first.compare(0, query.playerName.size(), query.playerName) == 0; ++prefixEnd)
+                if (!visit(prefixEnd->second))
+                    return matchCount;
+
+            for (NameIndex::const_iterator itr = nameIndex.begin(); itr != prefixBegin; ++itr)
+                if (!visit(itr->second))
+                    return matchCount;
+
+            for (NameIndex::const_iterator itr = prefixEnd; itr != nameIndex.end(); ++itr)
+                if (!visit(itr->second))
+                    return matchCount;
+        }
+        else
+        {
+            LevelIndex const& levelIndex = m_levelIndex[teamIndex];
+            for (uint32 level = query.levelMin; level <= levelMax; ++level)
+                for (WhoListEntry const* entry : levelIndex[level])
+                    if (!visit(entry))
+                        return matchCount;
+        }
+    }
+
+    return matchCount;
+}
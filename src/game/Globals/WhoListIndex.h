@@ -0,0 +1,121 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_WHOLISTINDEX_H
+#define MANGOS_WHOLISTINDEX_H
+
+#include "Common.h"
+#include "Platform/Define.h"
+#include "Policies/Singleton.h"
+#include "Entities/ObjectGuid.h"
+#include "Server/DBCEnums.h"
+#include "Globals/SharedDefines.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Player;
+
+// Online player data used by /who, kept up to date on login, logout, level, zone and guild changes
+struct WhoListEntry
+{
+    Player* player;
+    std::string name;
+    std::wstring lowerName;
+    uint32 guildId;
+    std::string guildName;
+    std::wstring lowerGuildName;
+    uint32 level;
+    uint32 zoneId;
+    PvpTeamIndex teamIndex;
+};
+
+struct WhoListQuery
+{
+    Player* searcher;
+    bool allTeams;                                          // else searcher team only
+    bool hideGameMasters;                                   // hide players with security above maxSecurity
+    AccountTypes maxSecurity;
+    uint32 levelMin;
+    uint32 levelMax;
+    uint32 raceMask;
+    uint32 classMask;
+    std::vector<uint32> zoneIds;                            // empty for any zone
+    std::wstring playerName;                                // lowercase, empty for any
+    std::wstring guildName;                                 // lowercase, empty for any
+    std::vector<std::wstring> strings;                      // lowercase user strings, matched against name, guild and zone name
+    LocaleConstant locale;
+};
+
+struct WhoListResult
+{
+    std::string name;
+    std::string guildName;
+    uint32 level;
+    uint32 classId;
+    uint32 race;
+    uint8 gender;
+    uint32 zoneId;
+};
+
+class WhoListIndex
+{
+    public:
+        WhoListIndex();
+
+        void AddPlayer(Player* player);
+        void RemovePlayer(Player* player);
+        void UpdateLevel(Player* player, uint32 level);
+        void UpdateZone(Player* player, uint32 zoneId);
+        void UpdateGuild(Player* player, uint32 guildId);
+
+        // Fills result with up to maxResults matching players and returns the match count,
+        // counting stops at maxCount once result is full (0 counts every match)
+        uint32 Query(WhoListQuery const& query, std::vector<WhoListResult>& result, uint32 maxResults, uint32 maxCount) const;
+        // Calls executor for each online player of an account above SEC_PLAYER, under the index lock
+        void DoForStaff(std::function<void(Player*)> const& executor) const;
+
+    private:
+        typedef std::unordered_map<ObjectGuid, WhoListEntry> EntryMap;
+        typedef std::unordered_set<WhoListEntry*> EntrySet;
+        typedef std::map<std::wstring, WhoListEntry*> NameIndex;
+        typedef std::unordered_map<uint32, EntrySet> ZoneIndex;
+        typedef std::vector<EntrySet> LevelIndex;
+
+        void Link(WhoListEntry* entry);
+        void Unlink(WhoListEntry* entry);
+        bool Matches(WhoListQuery const& query, WhoListEntry const* entry) const;
+
+        EntryMap m_entries;
+        // per team buckets, names are sorted so a name prefix selects a contiguous range
+        NameIndex m_nameIndex[PVP_TEAM_COUNT];
+        ZoneIndex m_zoneIndex[PVP_TEAM_COUNT];
+        LevelIndex m_levelIndex[PVP_TEAM_COUNT];
+        EntrySet m_staff;
+
+        mutable std::mutex m_lock;
+};
+
+#define sWhoListIndex MaNGOS::Singleton<WhoListIndex>::Instance()
+
+#endif
@@ -132,6 +132,21 @@ void VisibleNotifier::Notify()
     }
 }
 
+void BroadcastMessage::SendTo(WorldSession& session)
+{
+    // small packets are copied into the socket buffer anyway
+    if (m_message.size() < MaNGOS::Socket::SharedContentMinSize)
+    {
+        session.SendPacket(m_message);
+        return;
+    }
+
+    if (!m_shared)
+        m_shared = std::make_shared<WorldPacket const>(m_message);
+
+    session.SendPacket(m_shared);
+}
+
 void MessageDeliverer::Visit(CameraMapType& m)
 {
     for (auto& iter : m)
@@ -144,7 +159,7 @@ void MessageDeliverer::Visit(CameraMapType& m)
                 continue;
 
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                i_message.SendTo(*session);
         }
     }
 }
@@ -159,7 +174,7 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
             continue;
 
         if (WorldSession* session = owner->GetSession())
-            session->SendPacket(i_message);
+            i_message.SendTo(*session);
     }
 }
 
@@ -171,7 +186,7 @@ void ObjectMessageDeliverer::Visit(CameraMapType& m)
             continue;
 
         if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-            session->SendPacket(i_message);
+            i_message.SendTo(*session);
     }
 }
 
@@ -189,7 +204,7 @@ void MessageDistDeliverer::Visit(CameraMapType& m)
                 continue;
 
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                i_message.SendTo(*session);
         }
     }
 }
@@ -204,7 +219,7 @@ void ObjectMessageDistDeliverer::Visit(CameraMapType& m)
                 continue;
 
             if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-                session->SendPacket(i_message);
+                i_message.SendTo(*session);
         }
     }
 }
@@ -222,7 +237,7 @@ void SpellMessageDestLocDeliverer::Visit(CameraMapType& m)
 
         if (WorldSession* session = player->GetSession())
         {
-            session->SendPacket(i_message);
+            i_message.SendTo(*session);
             if (i_accumulate)
                 i_guids.insert(player->GetObjectGuid());
         }
@@ -59,10 +59,23 @@ namespace MaNGOS
         GuidSet m_unvisitedGuids;
     };
 
+    // packet sent to many sessions: copied once on first use, every receiver then queues the same copy
+    class BroadcastMessage
+    {
+        public:
+            explicit BroadcastMessage(WorldPacket const& message) : m_message(message) {}
+
+            void SendTo(WorldSession& session);
+
+        private:
+            WorldPacket const& m_message;
+            std::shared_ptr<WorldPacket const> m_shared;
+    };
+
     struct MessageDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        BroadcastMessage i_message;
         bool i_toSelf;
         MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
@@ -72,7 +85,7 @@ namespace MaNGOS
     struct MessageDelivererExcept
     {
         uint32        i_phaseMask;
-        WorldPacket const& i_message;
+        BroadcastMessage i_message;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldObject const* obj, WorldPacket const& msg, Player const* skipped)
@@ -85,7 +98,7 @@ namespace MaNGOS
     struct ObjectMessageDeliverer
     {
         uint32 i_phaseMask;
-        WorldPacket const& i_message;
+        BroadcastMessage i_message;
         explicit ObjectMessageDeliverer(WorldObject const& obj, WorldPacket const& msg)
             : i_phaseMask(obj.GetPhaseMask()), i_message(msg) {}
         void Visit(CameraMapType& m);
@@ -95,7 +108,7 @@ namespace MaNGOS
     struct MessageDistDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        BroadcastMessage i_message;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
@@ -109,7 +122,7 @@ namespace MaNGOS
     struct ObjectMessageDistDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket const& i_message;
+        BroadcastMessage i_message;
         float i_dist;
         ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
@@ -119,7 +132,7 @@ namespace MaNGOS
     struct SpellMessageDestLocDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket const& i_message;
+        BroadcastMessage i_message;
         bool i_accumulate;
         GuidSet i_guids;
         SpellMessageDestLocDeliverer(WorldObject const& obj, WorldPacket const& msg) : i_object(obj), i_message(msg), i_accumulate(true) {}
@@ -24,6 +24,8 @@
 #include "Policies/Singleton.h"
 #include "Util/ProgressBar.h"
 #include "World/World.h"
+#include "Globals/ObjectAccessor.h"
+#include "Globals/WhoListIndex.h"
 
 INSTANTIATE_SINGLETON_1(GuildMgr);
 
@@ -40,6 +42,10 @@ GuildMgr::~GuildMgr()
 void GuildMgr::AddGuild(Guild* guild)
 {
     m_GuildMap[guild->GetId()] = guild;
+
+    // a new guild leader joins before the guild is registered here, refresh the guild name shown in /who
+    if (Player* leader = ObjectAccessor::FindPlayer(guild->GetLeaderGuid(), false))
+        sWhoListIndex.UpdateGuild(leader, guild->GetId());
 }
 
 void GuildMgr::RemoveGuild(uint32 guildId)
@@ -828,7 +828,7 @@ void LfgRaidBrowser::Update(World* world)
         }
     }
 
-    // runs in world thread - always safe to work with sessions
+    // runs in world thread, listed data is only changed there - may overlap with map updates
     for (auto& data : m_changed)
     {
         if (data.second == false) // not changed
@@ -842,16 +842,21 @@ void LfgRaidBrowser::Update(World* world)
 
         data.second = false; // set to unchanged and process all listeners
 
-        WorldPacket result = BuildSearchResults(dungeonId, Team(team));
-
-        for (ObjectGuid guid : listeners)
-        {
-            Player* plr = ObjectAccessor::FindPlayer(guid);
-            plr->GetSession()->SendPacket(result);
-        }
+        m_pendingResults.emplace_back(BuildSearchResults(dungeonId, Team(team)), listeners);
     }
 }
 
+void LfgRaidBrowser::SendSearchResults()
+{
+    // runs in world thread outside of map updates - always safe to work with sessions
+    for (auto& result : m_pendingResults)
+        for (ObjectGuid guid : result.second)
+            if (Player* plr = ObjectAccessor::FindPlayer(guid))
+                plr->GetSession()->SendPacket(result.first);
+
+    m_pendingResults.clear();
+}
+
 void LfgRaidBrowser::ProcessDungeons(LfgDungeonSet const& dungeons, uint32 team, ObjectGuid guid)
 {
     for (uint32 dungeonId : dungeons)
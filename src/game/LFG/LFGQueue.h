@@ -175,7 +175,10 @@ class LfgRaidBrowser
         void SetPlayerRoles(ObjectGuid group, ObjectGuid player, uint8 roles);
         void UpdateComment(ObjectGuid guid, std::string comment);
 
+        // builds search results for changed dungeons, touches no players
         void Update(World* world);
+        // sends the results built by the last Update to their listeners
+        void SendSearchResults();
     private:
         void ProcessDungeons(LfgDungeonSet const& dungeons, uint32 team, ObjectGuid guid);
 
@@ -183,6 +186,7 @@ class LfgRaidBrowser
         std::map<std::pair<uint32, uint32>, ListedContainer> m_listedPerDungeon;
         std::map<std::pair<uint32, uint32>, bool> m_changed;
         std::map<std::pair<uint32, uint32>, std::vector<ObjectGuid>> m_listeners;
+        std::vector<std::pair<WorldPacket, std::vector<ObjectGuid>>> m_pendingResults;
 };
 
 #endif
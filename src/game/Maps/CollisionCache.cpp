@@ -0,0 +1,107 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/CollisionCache.h"
+#include "Maps/GridDefines.h"
+
+namespace
+{
+    // cells covered by the area, false if there are more than maxCells of them
+    bool GetCellRange(float minX, float minY, float maxX, float maxY, uint32 maxCells, int32& x1, int32& y1, int32& x2, int32& y2)
+    {
+        x1 = int32(std::floor(minX / SIZE_OF_GRID_CELL));
+        y1 = int32(std::floor(minY / SIZE_OF_GRID_CELL));
+        x2 = int32(std::floor(maxX / SIZE_OF_GRID_CELL));
+        y2 = int32(std::floor(maxY / SIZE_OF_GRID_CELL));
+        return uint64(x2 - x1 + 1) * uint64(y2 - y1 + 1) <= maxCells;
+    }
+
+    uint32 GetRegion(int32 x, int32 y, uint32 regions)
+    {
+        return ((uint32(x) * 0x9E3779B1) ^ (uint32(y) * 0x85EBCA6B)) % regions;
+    }
+}
+
+MapCollisionCache::MapCollisionCache(uint32 size) : m_mask(0), m_dynamicGeneration(0), m_dynamicChanges(0), m_hits(0), m_misses(0), m_missTime(0)
+{
+    for (auto& generation : m_regionGenerations)
+        generation.store(0, std::memory_order_relaxed);
+
+    if (!size)
+        return;
+
+    uint32 entries = 1;
+    while (entries < size && entries < 0x80000000)
+        entries <<= 1;
+
+    m_mask = entries - 1;
+    m_losEntries.resize(entries, LosEntry());
+    m_heightEntries.resize(entries, HeightEntry());
+}
+
+uint32 MapCollisionCache::Hash(int32 const* key, uint32 count, uint32 phaseMask, uint32 flags)
+{
+    uint32 hash = flags;
+    for (uint32 i = 0; i < count; ++i)
+        hash = (hash ^ uint32(key[i])) * 0x9E3779B1;
+    hash = (hash ^ phaseMask) * 0x9E3779B1;
+    return hash ^ (hash >> 16);
+}
+
+void MapCollisionCache::AddMiss(Clock::time_point start)
+{
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    m_missTime.fetch_add(uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()), std::memory_order_relaxed);
+}
+
+void MapCollisionCache::ResetCounters(uint32& hits, uint32& misses, uint64& missTime)
+{
+    hits = m_hits.exchange(0, std::memory_order_relaxed);
+    misses = m_misses.exchange(0, std::memory_order_relaxed);
+    missTime = m_missTime.exchange(0, std::memory_order_relaxed) / 1000;
+}
+
+void MapCollisionCache::InvalidateDynamic(float minX, float minY, float maxX, float maxY)
+{
+    m_dynamicChanges.fetch_add(1, std::memory_order_relaxed);
+
+    int32 x1, y1, x2, y2;
+    if (!GetCellRange(minX, minY, maxX, maxY, MAX_REGION_CELLS, x1, y1, x2, y2))
+    {
+        m_dynamicGeneration.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    for (int32 x = x1; x <= x2; ++x)
+        for (int32 y = y1; y <= y2; ++y)
+            m_regionGenerations[GetRegion(x, y, DYNAMIC_REGIONS)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32 MapCollisionCache::GetDynamicGeneration(float minX, float minY, float maxX, float maxY) const
+{
+    int32 x1, y1, x2, y2;
+    if (!GetCellRange(minX, minY, maxX, maxY, MAX_REGION_CELLS, x1, y1, x2, y2))
+        return m_dynamicChanges.load(std::memory_order_relaxed);
+
+    // counters only grow, so a change in any covered cell changes the sum
+    uint32 generation = m_dynamicGeneration.load(std::memory_order_relaxed);
+    for (int32 x = x1; x <= x2; ++x)
+        for (int32 y = y1; y <= y2; ++y)
+            generation += m_regionGenerations[GetRegion(x, y, DYNAMIC_REGIONS)].load(std::memory_order_relaxed);
+    return generation;
+}
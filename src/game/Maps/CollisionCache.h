@@ -0,0 +1,220 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _COLLISION_CACHE_H_INCLUDED
+#define _COLLISION_CACHE_H_INCLUDED
+
+#include "Platform/Define.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+// Bounded cache of line of sight and height results of one map, keyed on endpoints quantized
+// to 1/16 yard and the phase mask. Each result is split into its static part (terrain and vmaps)
+// and its dynamic part (gameobject models of the map). Both parts remember the generation of the
+// area they were computed for: the static one sums the grids the query covers, the dynamic one
+// the cells. Loading a grid or changing a gameobject model only makes queries touching that area
+// miss instead of returning stale data. Colliding keys simply replace each other.
+class MapCollisionCache
+{
+    public:
+        // size is the number of entries per query type, rounded up to a power of two; 0 disables the cache
+        explicit MapCollisionCache(uint32 size);
+        MapCollisionCache(const MapCollisionCache&) = delete;
+
+        bool IsEnabled() const { return m_mask != 0; }
+
+        // a gameobject model with the given bounds was added, removed or toggled
+        void InvalidateDynamic(float minX, float minY, float maxX, float maxY);
+
+        // staticGeneration is TerrainInfo::GetCollisionGeneration of the area the query covers
+        template<class StaticQuery, class DynamicQuery>
+        bool IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phaseMask, bool ignoreM2Model,
+                             uint32 staticGeneration, StaticQuery const& staticQuery, DynamicQuery const& dynamicQuery);
+
+        // dynamicQuery receives the static height
+        template<class StaticQuery, class DynamicQuery>
+        float GetHeight(float x, float y, float z, uint32 phaseMask, bool swim,
+                        uint32 staticGeneration, StaticQuery const& staticQuery, DynamicQuery const& dynamicQuery);
+
+        // statistics since the previous call: answered from cache, computed, microseconds spent computing
+        void ResetCounters(uint32& hits, uint32& misses, uint64& missTime);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        static uint32 const LOCK_STRIPES = 16;
+        static uint32 const DYNAMIC_REGIONS = 256;          // cells are hashed into this many generation counters
+        static uint32 const MAX_REGION_CELLS = 16;          // larger areas use the map wide counters
+
+        struct LosEntry
+        {
+            int32 key[6];
+            uint32 phaseMask;
+            uint32 flags;                                   // 0 for unused entries
+            uint32 staticGeneration;
+            uint32 dynamicGeneration;
+            bool staticResult;
+            bool dynamicResult;
+        };
+
+        struct HeightEntry
+        {
+            int32 key[3];
+            uint32 phaseMask;
+            uint32 flags;                                   // 0 for unused entries
+            uint32 staticGeneration;
+            uint32 dynamicGeneration;
+            float staticHeight;
+            float dynamicHeight;
+        };
+
+        enum KeyFlags
+        {
+            KEY_FLAG_USED           = 0x1,
+            KEY_FLAG_IGNORE_M2      = 0x2,
+            KEY_FLAG_SWIM           = 0x4,
+        };
+
+        static int32 Quantize(float value) { return int32(std::floor(value * 16.0f)); }
+        static uint32 Hash(int32 const* key, uint32 count, uint32 phaseMask, uint32 flags);
+        std::mutex& GetLock(uint32 index) { return m_locks[index & (LOCK_STRIPES - 1)]; }
+        void AddMiss(Clock::time_point start);
+        uint32 GetDynamicGeneration(float minX, float minY, float maxX, float maxY) const;
+
+        uint32 m_mask;
+        std::vector<LosEntry> m_losEntries;
+        std::vector<HeightEntry> m_heightEntries;
+        std::mutex m_locks[LOCK_STRIPES];
+        std::atomic<uint32> m_dynamicGeneration;            // changes covering more than MAX_REGION_CELLS cells
+        std::atomic<uint32> m_dynamicChanges;               // every change, for queries covering more than MAX_REGION_CELLS cells
+        std::atomic<uint32> m_regionGenerations[DYNAMIC_REGIONS];
+
+        std::atomic<uint32> m_hits;
+        std::atomic<uint32> m_misses;
+        std::atomic<uint64> m_missTime;                     // nanoseconds
+};
+
+template<class StaticQuery, class DynamicQuery>
+bool MapCollisionCache::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phaseMask, bool ignoreM2Model,
+                                        uint32 staticGeneration, StaticQuery const& staticQuery, DynamicQuery const& dynamicQuery)
+{
+    int32 const key[6] = { Quantize(srcX), Quantize(srcY), Quantize(srcZ), Quantize(destX), Quantize(destY), Quantize(destZ) };
+    uint32 const flags = KEY_FLAG_USED | (ignoreM2Model ? KEY_FLAG_IGNORE_M2 : 0);
+    uint32 const index = Hash(key, 6, phaseMask, flags) & m_mask;
+    uint32 const dynamicGeneration = GetDynamicGeneration(std::min(srcX, destX), std::min(srcY, destY), std::max(srcX, destX), std::max(srcY, destY));
+
+    bool haveStatic = false, haveDynamic = false;
+    bool staticResult = false, dynamicResult = false;
+    {
+        std::lock_guard<std::mutex> guard(GetLock(index));
+        LosEntry const& entry = m_losEntries[index];
+        if (entry.flags == flags && entry.phaseMask == phaseMask && entry.staticGeneration == staticGeneration &&
+            std::equal(key, key + 6, entry.key))
+        {
+            haveStatic = true;
+            staticResult = entry.staticResult;
+            haveDynamic = entry.dynamicGeneration == dynamicGeneration;
+            dynamicResult = entry.dynamicResult;
+        }
+    }
+
+    // blocked by static geometry does not depend on the dynamic tree
+    if (haveStatic && (!staticResult || haveDynamic))
+    {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return staticResult && dynamicResult;
+    }
+
+    Clock::time_point const start = Clock::now();
+    if (!haveStatic)
+        staticResult = staticQuery();
+    dynamicResult = staticResult && dynamicQuery();
+    AddMiss(start);
+
+    {
+        std::lock_guard<std::mutex> guard(GetLock(index));
+        LosEntry& entry = m_losEntries[index];
+        std::copy(key, key + 6, entry.key);
+        entry.phaseMask = phaseMask;
+        entry.flags = flags;
+        entry.staticGeneration = staticGeneration;
+        entry.dynamicGeneration = dynamicGeneration;
+        entry.staticResult = staticResult;
+        entry.dynamicResult = dynamicResult;
+    }
+
+    return staticResult && dynamicResult;
+}
+
+template<class StaticQuery, class DynamicQuery>
+float MapCollisionCache::GetHeight(float x, float y, float z, uint32 phaseMask, bool swim,
+                                   uint32 staticGeneration, StaticQuery const& staticQuery, DynamicQuery const& dynamicQuery)
+{
+    int32 const key[3] = { Quantize(x), Quantize(y), Quantize(z) };
+    uint32 const flags = KEY_FLAG_USED | (swim ? KEY_FLAG_SWIM : 0);
+    uint32 const index = Hash(key, 3, phaseMask, flags) & m_mask;
+    uint32 const dynamicGeneration = GetDynamicGeneration(x, y, x, y);
+
+    bool haveStatic = false, haveDynamic = false;
+    float staticHeight = 0.0f, dynamicHeight = 0.0f;
+    {
+        std::lock_guard<std::mutex> guard(GetLock(index));
+        HeightEntry const& entry = m_heightEntries[index];
+        if (entry.flags == flags && entry.phaseMask == phaseMask && entry.staticGeneration == staticGeneration &&
+            std::equal(key, key + 3, entry.key))
+        {
+            haveStatic = true;
+            staticHeight = entry.staticHeight;
+            haveDynamic = entry.dynamicGeneration == dynamicGeneration;
+            dynamicHeight = entry.dynamicHeight;
+        }
+    }
+
+    if (haveDynamic)
+    {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return std::max(staticHeight, dynamicHeight);
+    }
+
+    Clock::time_point const start = Clock::now();
+    if (!haveStatic)
+        staticHeight = staticQuery();
+    dynamicHeight = dynamicQuery(staticHeight);
+    AddMiss(start);
+
+    {
+        std::lock_guard<std::mutex> guard(GetLock(index));
+        HeightEntry& entry = m_heightEntries[index];
+        std::copy(key, key + 3, entry.key);
+        entry.phaseMask = phaseMask;
+        entry.flags = flags;
+        entry.staticGeneration = staticGeneration;
+        entry.dynamicGeneration = dynamicGeneration;
+        entry.staticHeight = staticHeight;
+        entry.dynamicHeight = dynamicHeight;
+    }
+
+    return std::max(staticHeight, dynamicHeight);
+}
+
+#endif
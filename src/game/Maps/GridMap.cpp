@@ -719,6 +719,7 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
             m_GridMaps[i][k] = nullptr;
             m_GridRef[i][k] = 0;
             m_GridMapsLoadAttempted[i][k] = false;
+            m_collisionGenerations[i][k].store(0, std::memory_order_relaxed);
         }
     }
 
@@ -743,7 +744,7 @@ TerrainInfo::~TerrainInfo()
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
 }
 
-GridMap* TerrainInfo::Load(const uint32 x, const uint32 y, bool mapOnly /*= false*/)
+GridMap* TerrainInfo::Load(const uint32 x, const uint32 y, bool mapOnly /*= false*/, std::unique_ptr<GridMap> preloaded /*= nullptr*/)
 {
     MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
     MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
@@ -755,7 +756,7 @@ GridMap* TerrainInfo::Load(const uint32 x, const uint32 y, bool mapOnly /*= fals
     GridMap* pMap = m_GridMaps[x][y];
     if (!pMap)
     {
-        pMap = LoadMapAndVMap(x, y, mapOnly);
+        pMap = LoadMapAndVMap(x, y, mapOnly, std::move(preloaded));
         m_GridMapsLoadAttempted[x][y] = true;
     }
 
@@ -804,6 +805,7 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
 
                 // unload VMAPS...
                 m_vmgr->unloadMap(m_mapId, x, y);
+                m_collisionGenerations[x][y].fetch_add(1, std::memory_order_release);
 
                 // unload mmap... - not possible like this - mmaps are per-map
                 // MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
@@ -1305,6 +1307,22 @@ float TerrainInfo::GetWaterOrGroundLevel(float x, float y, float /*z*/, float& g
     return VMAP_INVALID_HEIGHT_VALUE;
 }
 
+uint32 TerrainInfo::GetCollisionGeneration(float x1, float y1, float x2, float y2) const
+{
+    // grid indexes decrease with the coordinates, see GetGrid
+    int gx1 = std::max(0, std::min(MAX_NUMBER_OF_GRIDS - 1, int(32 - std::max(x1, x2) / SIZE_OF_GRIDS)));
+    int gx2 = std::max(0, std::min(MAX_NUMBER_OF_GRIDS - 1, int(32 - std::min(x1, x2) / SIZE_OF_GRIDS)));
+    int gy1 = std::max(0, std::min(MAX_NUMBER_OF_GRIDS - 1, int(32 - std::max(y1, y2) / SIZE_OF_GRIDS)));
+    int gy2 = std::max(0, std::min(MAX_NUMBER_OF_GRIDS - 1, int(32 - std::min(y1, y2) / SIZE_OF_GRIDS)));
+
+    // counters only grow, so a change in any covered grid changes the sum
+    uint32 generation = 0;
+    for (int gx = gx1; gx <= gx2; ++gx)
+        for (int gy = gy1; gy <= gy2; ++gy)
+            generation += m_collisionGenerations[gx][gy].load(std::memory_order_acquire);
+    return generation;
+}
+
 GridMap* TerrainInfo::GetGrid(const float x, const float y, bool loadOnlyMap /*= false*/)
 {
     // half opt method
@@ -1324,7 +1342,27 @@ GridMap* TerrainInfo::GetGrid(const float x, const float y, bool loadOnlyMap /*=
     return pMap;
 }
 
-GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnly /*= false*/)
+GridMap* TerrainInfo::ReadGridMap(const uint32 mapId, const uint32 x, const uint32 y)
+{
+    GridMap* map = new GridMap();
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error loading map file: %s", tmp);
+        //assert(false);
+    }
+
+    delete[] tmp;
+    return map;
+}
+
+GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnly /*= false*/, std::unique_ptr<GridMap> preloaded /*= nullptr*/)
 {
     if ((m_GridMaps[x][y] && mapOnly) || m_vmgr->IsTileLoaded(m_mapId, x, y))
     {
@@ -1336,29 +1374,15 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
         LOCK_GUARD lock(m_mutex);
         // double checked lock pattern
         if (!m_GridMaps[x][y])
-        {
-            GridMap* map = new GridMap();
-
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
-
-            if (!map->loadData(tmp))
-            {
-                sLog.outError("Error loading map file: %s", tmp);
-                //assert(false);
-            }
-
-            delete[] tmp;
-            m_GridMaps[x][y] = map;
-        }
+            m_GridMaps[x][y] = preloaded ? preloaded.release() : ReadGridMap(m_mapId, x, y);
     }
 
     // we'll load the rest later
     if (mapOnly)
+    {
+        m_collisionGenerations[x][y].fetch_add(1, std::memory_order_release);
         return m_GridMaps[x][y];
+    }
 
     if (!m_vmgr->IsTileLoaded(m_mapId, x, y))
     {
@@ -1384,6 +1408,8 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
     if (m_GridMaps[x][y])
         m_GridMaps[x][y]->SetFullyLoaded();
 
+    m_collisionGenerations[x][y].fetch_add(1, std::memory_order_release);
+
     return  m_GridMaps[x][y];
 }
 
@@ -27,6 +27,7 @@
 #include "Maps/GridMapDefines.h"
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 
 class Creature;
@@ -175,11 +176,17 @@ class TerrainInfo : public Referencable<std::atomic_long>
 
         bool CanCheckLiquidLevel(float x, float y) const;
 
+        // changes whenever grid or vmap data of a grid the area touches is loaded or unloaded, see MapCollisionCache
+        uint32 GetCollisionGeneration(float x1, float y1, float x2, float y2) const;
+
+        // read the terrain file of a grid, safe to call from any thread
+        static GridMap* ReadGridMap(const uint32 mapId, const uint32 x, const uint32 y);
+
     protected:
         friend class Map;
         friend class ObjectMgr;
-        // load/unload terrain data
-        GridMap* Load(const uint32 x, const uint32 y, bool mapOnly = false);
+        // load/unload terrain data, a grid map read in advance is used instead of the file if given
+        GridMap* Load(const uint32 x, const uint32 y, bool mapOnly = false, std::unique_ptr<GridMap> preloaded = nullptr);
         void Unload(const uint32 x, const uint32 y);
 
     private:
@@ -187,7 +194,7 @@ class TerrainInfo : public Referencable<std::atomic_long>
         TerrainInfo& operator=(const TerrainInfo&);
 
         GridMap* GetGrid(const float x, const float y, bool loadOnlyMap = false);
-        GridMap* LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnly = false);
+        GridMap* LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnly = false, std::unique_ptr<GridMap> preloaded = nullptr);
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
@@ -203,6 +210,8 @@ class TerrainInfo : public Referencable<std::atomic_long>
 
         VMAP::IVMapManager* m_vmgr;
 
+        std::atomic<uint32> m_collisionGenerations[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+
         typedef std::mutex LOCK_TYPE;
         typedef std::lock_guard<LOCK_TYPE> LOCK_GUARD;
         LOCK_TYPE m_mutex;
@@ -0,0 +1,180 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/GridPreloader.h"
+#include "Maps/GridMap.h"
+#include "MotionGenerators/MoveMap.h"
+
+#include <algorithm>
+
+// data not taken within this time is most likely not needed anymore (player turned around)
+static const std::chrono::seconds GRID_PRELOAD_EXPIRY(60);
+
+PreloadedGrid::PreloadedGrid() : mmapTile(new MMAP::MMapTileData)
+{
+}
+
+PreloadedGrid::~PreloadedGrid()
+{
+}
+
+GridPreloader::GridPreloader() : m_stop(false), m_hits(0), m_late(0), m_misses(0)
+{
+}
+
+GridPreloader::~GridPreloader()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+GridPreloader::GridKey GridPreloader::MakeKey(uint32 mapId, uint32 instanceId, uint32 x, uint32 y)
+{
+    return GridKey((uint64(mapId) << 32) | instanceId, (x << 16) | y);
+}
+
+void GridPreloader::Request(uint32 mapId, uint32 instanceId, uint32 x, uint32 y)
+{
+    GridKey const key = MakeKey(mapId, instanceId, x, y);
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_entries.find(key) != m_entries.end())
+            return;
+
+        PurgeExpired();
+
+        m_entries.emplace(key, Entry());
+        m_queue.push_back(key);
+
+        // started on first use, most servers never enable preloading
+        if (!m_thread.joinable())
+            m_thread = std::thread(&GridPreloader::run, this);
+    }
+    m_condition.notify_one();
+}
+
+bool GridPreloader::IsReady(uint32 mapId, uint32 instanceId, uint32 x, uint32 y)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_entries.find(MakeKey(mapId, instanceId, x, y));
+    return itr != m_entries.end() && itr->second.ready;
+}
+
+std::unique_ptr<PreloadedGrid> GridPreloader::Take(uint32 mapId, uint32 instanceId, uint32 x, uint32 y)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_entries.find(MakeKey(mapId, instanceId, x, y));
+    if (itr == m_entries.end())
+    {
+        ++m_misses;
+        return nullptr;
+    }
+
+    // still queued or being read, the map loads the grid itself and the result is thrown away
+    if (!itr->second.ready)
+    {
+        ++m_late;
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), itr->first), m_queue.end());
+        m_entries.erase(itr);
+        return nullptr;
+    }
+
+    ++m_hits;
+    std::unique_ptr<PreloadedGrid> data = std::move(itr->second.data);
+    m_entries.erase(itr);
+    return data;
+}
+
+void GridPreloader::Cancel(uint32 mapId, uint32 instanceId)
+{
+    uint64 const instanceKey = (uint64(mapId) << 32) | instanceId;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [instanceKey](GridKey const& key) { return key.first == instanceKey; }), m_queue.end());
+
+    // data of a grid being read right now is dropped by the thread once it finds its entry gone
+    for (auto itr = m_entries.begin(); itr != m_entries.end();)
+    {
+        if (itr->first.first == instanceKey)
+            itr = m_entries.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+void GridPreloader::ResetCounters(uint32& hits, uint32& late, uint32& misses)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    hits = m_hits;
+    late = m_late;
+    misses = m_misses;
+    m_hits = m_late = m_misses = 0;
+}
+
+void GridPreloader::PurgeExpired()
+{
+    Clock::time_point const expiry = Clock::now() - GRID_PRELOAD_EXPIRY;
+    for (auto itr = m_entries.begin(); itr != m_entries.end();)
+    {
+        if (itr->second.ready && itr->second.readyTime <= expiry)
+            itr = m_entries.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+void GridPreloader::run()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (true)
+    {
+        m_condition.wait(guard, [this] { return m_stop || !m_queue.empty(); });
+        if (m_stop)
+            return;
+
+        GridKey const key = m_queue.front();
+        m_queue.pop_front();
+
+        guard.unlock();
+
+        uint32 const mapId = uint32(key.first >> 32);
+        uint32 const x = key.second >> 16;
+        uint32 const y = key.second & 0xFFFF;
+
+        std::unique_ptr<PreloadedGrid> data(new PreloadedGrid);
+        data->gridMap.reset(TerrainInfo::ReadGridMap(mapId, x, y));
+        MMAP::MMapManager::readTile(mapId, x, y, 0, *data->mmapTile);
+
+        guard.lock();
+
+        // the entry is gone if the map was unloaded or loaded the grid itself meanwhile
+        auto itr = m_entries.find(key);
+        if (itr != m_entries.end())
+        {
+            itr->second.data = std::move(data);
+            itr->second.ready = true;
+            itr->second.readyTime = Clock::now();
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _GRID_PRELOADER_H_INCLUDED
+#define _GRID_PRELOADER_H_INCLUDED
+
+#include "Platform/Define.h"
+
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <condition_variable>
+
+class GridMap;
+
+namespace MMAP
+{
+    struct MMapTileData;
+}
+
+// terrain and navmesh data of one grid, read from disk ahead of the map update needing it
+struct PreloadedGrid
+{
+    PreloadedGrid();
+    ~PreloadedGrid();
+
+    std::unique_ptr<GridMap> gridMap;
+    std::unique_ptr<MMAP::MMapTileData> mmapTile;
+};
+
+// Reads grid files on a background thread so that a map only has to install ready data when
+// a player enters the grid. Requests are made by Map::UpdateGridPreload from predicted positions.
+class GridPreloader
+{
+    public:
+        GridPreloader();
+        GridPreloader(const GridPreloader&) = delete;
+        ~GridPreloader();
+
+        // queue a grid (terrain file coordinates) for background reading, ignored if already queued or read
+        void Request(uint32 mapId, uint32 instanceId, uint32 x, uint32 y);
+        // true if the grid was requested and its data can be taken without waiting
+        bool IsReady(uint32 mapId, uint32 instanceId, uint32 x, uint32 y);
+        // take the data of a grid about to be loaded, null if it was not predicted or is still being read
+        std::unique_ptr<PreloadedGrid> Take(uint32 mapId, uint32 instanceId, uint32 x, uint32 y);
+        // drop all requests and data of a map instance
+        void Cancel(uint32 mapId, uint32 instanceId);
+
+        // load statistics since the previous call: data ready in time, requested but still read, never requested
+        void ResetCounters(uint32& hits, uint32& late, uint32& misses);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+        typedef std::pair<uint64, uint32> GridKey;
+
+        struct Entry
+        {
+            Entry() : ready(false) {}
+
+            std::unique_ptr<PreloadedGrid> data;
+            bool ready;
+            Clock::time_point readyTime;
+        };
+
+        static GridKey MakeKey(uint32 mapId, uint32 instanceId, uint32 x, uint32 y);
+
+        void run();
+        void PurgeExpired();
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::deque<GridKey> m_queue;
+        std::map<GridKey, Entry> m_entries;
+        std::thread m_thread;
+        bool m_stop;
+
+        uint32 m_hits;
+        uint32 m_late;
+        uint32 m_misses;
+};
+
+#endif
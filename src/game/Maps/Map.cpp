@@ -18,6 +18,7 @@
 
 #include "Maps/Map.h"
 #include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
 #include "Entities/Player.h"
 #include "Grids/GridNotifiers.h"
 #include "Log/Log.h"
@@ -37,6 +38,7 @@
 #include "Maps/MapPersistentStateMgr.h"
 #include "Vmap/VMapFactory.h"
 #include "MotionGenerators/MoveMap.h"
+#include "Movement/MoveSpline.h"
 #include "Calendar/Calendar.h"
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
@@ -206,11 +208,104 @@ void Map::LoadMapAndVMap(int gx, int gy)
     if (m_bLoadedGrids[gx][gy])
         return;
 
-    if (m_TerrainData->Load(gx, gy)) // fails also on maps which have no tiles for everything except mmaps
+    // data read in advance, see Map::UpdateGridPreload
+    std::unique_ptr<PreloadedGrid> preloaded;
+    if (sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_LOOKAHEAD))
+        preloaded = sMapMgr.GetGridPreloader().Take(GetId(), GetInstanceId(), gx, gy);
+
+    if (m_TerrainData->Load(gx, gy, false, preloaded ? std::move(preloaded->gridMap) : nullptr)) // fails also on maps which have no tiles for everything except mmaps
         m_bLoadedGrids[gx][gy] = true;
 
-    if (!MMAP::MMapFactory::createOrGetMMapManager()->IsMMapTileLoaded(GetId(), GetInstanceId(), gx, gy))
-        MMAP::MMapFactory::createOrGetMMapManager()->loadMap(GetId(), GetInstanceId(), gx, gy, 0);
+    MMAP::MMapManager* mmapMgr = MMAP::MMapFactory::createOrGetMMapManager();
+    if (!mmapMgr->IsMMapTileLoaded(GetId(), GetInstanceId(), gx, gy))
+    {
+        if (preloaded)
+            mmapMgr->loadMap(GetId(), GetInstanceId(), gx, gy, *preloaded->mmapTile);
+        else
+            mmapMgr->loadMap(GetId(), GetInstanceId(), gx, gy, 0);
+    }
+}
+
+void Map::UpdateGridPreload(uint32 diff)
+{
+    uint32 const lookAhead = sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_LOOKAHEAD);
+    if (!lookAhead)
+        return;
+
+    m_gridPreloadTimer += diff;
+    if (m_gridPreloadTimer < GRID_PRELOAD_INTERVAL)
+        return;
+
+    uint32 const elapsed = m_gridPreloadTimer;
+    m_gridPreloadTimer = 0;
+
+    GridPreloader& preloader = sMapMgr.GetGridPreloader();
+    std::map<ObjectGuid, Position> positions;
+    bool objectsLoaded = false;
+
+    for (auto& ref : m_mapRefManager)
+    {
+        Player* player = ref.getSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        Position const& pos = player->GetPosition();
+        positions[player->GetObjectGuid()] = pos;
+
+        float x, y;
+        if (!player->movespline->Finalized())
+        {
+            // spline movement (taxi flights), the path tells where the player will be
+            Movement::MoveSpline const& spline = *player->movespline;
+            int32 idx = spline._currentSplineIdx() + 1;
+            while (idx < spline._Spline().last() && spline.ComputeTimeToIndex(idx) < int32(lookAhead))
+                ++idx;
+
+            G3D::Vector3 const& point = spline._Spline().getPoint(idx);
+            x = point.x;
+            y = point.y;
+        }
+        else
+        {
+            // extrapolate the movement since the previous prediction
+            auto itr = m_gridPreloadPositions.find(player->GetObjectGuid());
+            if (itr == m_gridPreloadPositions.end())
+                continue;
+
+            float const factor = float(lookAhead) / elapsed;
+            x = pos.x + (pos.x - itr->second.x) * factor;
+            y = pos.y + (pos.y - itr->second.y) * factor;
+        }
+
+        if (!MaNGOS::IsValidMapCoord(x, y))
+            continue;
+
+        GridPair const p = MaNGOS::ComputeGridPair(x, y);
+        NGridType* grid = getNGrid(p.x_coord, p.y_coord);
+        if (grid && grid->isGridObjectDataLoaded())
+            continue;
+
+        // z coord
+        int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+        int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+        // first let the files be read in the background
+        if (!m_bLoadedGrids[gx][gy] && !preloader.IsReady(GetId(), GetInstanceId(), gx, gy))
+        {
+            preloader.Request(GetId(), GetInstanceId(), gx, gy);
+            continue;
+        }
+
+        // then spawn its objects before the player arrives, one grid per prediction to spread the cost
+        if (!objectsLoaded)
+        {
+            Cell cell(MaNGOS::ComputeCellPair(x, y));
+            EnsureGridLoadedAtEnter(cell);
+            objectsLoaded = true;
+        }
+    }
+
+    std::swap(m_gridPreloadPositions, positions);
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
@@ -220,7 +315,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
       i_data(nullptr), i_script_id(0), m_transportsIterator(m_transports.begin()), m_defaultLight(GetDefaultMapLight(id)), m_spawnManager(*this),
-      m_variableManager(this)
+      m_variableManager(this), m_lastUpdateCost(0), m_gridPreloadTimer(0), m_parallelObjectUpdate(false),
+      m_collisionCache(sWorld.getConfig(CONFIG_UINT32_COLLISION_CACHE_SIZE))
 {
     m_weatherSystem = new WeatherSystem(this);
 }
@@ -743,6 +839,25 @@ void Map::Update(const uint32& t_diff)
 
     m_curTime = time(nullptr);
 
+#ifdef BUILD_METRICS
+    if (m_collisionCache.IsEnabled())
+    {
+        uint32 hits, misses;
+        uint64 missTime;
+        m_collisionCache.ResetCounters(hits, misses, missTime);
+        if (hits || misses)
+        {
+            metric::measurement meas_cache("map.collision_cache", {
+                { "map_id", std::to_string(i_id) },
+                { "instance_id", std::to_string(i_InstanceId) }
+            });
+            meas_cache.add_field("hits", std::to_string(hits));
+            meas_cache.add_field("misses", std::to_string(misses));
+            meas_cache.add_field("miss_time_us", std::to_string(missTime));
+        }
+    }
+#endif
+
 #ifdef _MSC_VER
     localtime_s(&m_curTimeTm, &m_curTime);
 #else
@@ -756,6 +871,8 @@ void Map::Update(const uint32& t_diff)
     GetMessager().Execute(this);
     m_spawnManager.Update();
 
+    UpdateGridPreload(t_diff);
+
     /// update active cells around players and active objects
     resetMarkedCells();
 
@@ -863,10 +980,18 @@ void Map::Update(const uint32& t_diff)
     }
 
     // update all objects
-    for (auto wObj : objToUpdate)
+    if (CanUpdateObjectsInParallel(objToUpdate.size()))
     {
-        wObj->Update(t_diff);
-        ++count;
+        UpdateObjectsInParallel(objToUpdate, t_diff);
+        count = objToUpdate.size();
+    }
+    else
+    {
+        for (auto wObj : objToUpdate)
+        {
+            wObj->Update(t_diff);
+            ++count;
+        }
     }
 
 #ifdef BUILD_METRICS
@@ -905,6 +1030,113 @@ void Map::Update(const uint32& t_diff)
     m_weatherSystem->UpdateWeathers(t_diff);
 }
 
+bool Map::CanUpdateObjectsInParallel(size_t objectCount) const
+{
+    if (!IsContinent() || !sWorld.getConfig(CONFIG_BOOL_MAP_PARALLEL_OBJECT_UPDATE))
+        return false;
+
+    if (objectCount < sWorld.getConfig(CONFIG_UINT32_MAP_PARALLEL_OBJECT_UPDATE_MIN_OBJECTS))
+        return false;
+
+    return sMapMgr.GetUpdater().activated();
+}
+
+bool Map::CanUpdateObjectInParallel(WorldObject const* obj)
+{
+    // only idle creatures without scripts: their update is movement, regeneration and aura ticks
+    if (obj->GetTypeId() != TYPEID_UNIT)
+        return false;
+
+    Creature const* creature = static_cast<Creature const*>(obj);
+    if (creature->IsPet() || creature->IsTotem() || creature->IsPlayerControlled() || !creature->IsAlive() || creature->IsInCombat())
+        return false;
+
+    CreatureInfo const* cInfo = creature->GetCreatureInfo();
+    return !cInfo->ScriptID && (!cInfo->AIName || !*cInfo->AIName);
+}
+
+void Map::UpdateObjectsInParallel(WorldObjectUnSet& objToUpdate, uint32 diff)
+{
+    // Objects are split into regions by their grid. Grids are updated in four passes by parity of their
+    // coordinates, so grids updated at the same time are never adjacent. This only keeps the objects
+    // touched by grid visits apart: spells, threat, pathing and scripts still reach across the map.
+    // Everything that may run scripts is therefore updated first on this thread, the callbacks the
+    // remaining objects can still reach take GetScriptGuard(), and map wide containers take
+    // GetParallelUpdateGuard() while a pass runs. Navmesh queries are per thread and the dynamic
+    // tree is balanced before each pass, see Insert/RemoveGameObjectModel.
+    std::map<uint32, std::vector<WorldObject*>> passRegions[4];
+    for (WorldObject* obj : objToUpdate)
+    {
+        if (!CanUpdateObjectInParallel(obj))
+        {
+            obj->Update(diff);
+            continue;
+        }
+
+        GridPair p = MaNGOS::ComputeGridPair(obj->GetPositionX(), obj->GetPositionY());
+        uint32 pass = (p.x_coord & 1) | ((p.y_coord & 1) << 1);
+        passRegions[pass][p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord].push_back(obj);
+    }
+
+    MapUpdater& updater = sMapMgr.GetUpdater();
+    size_t maxParts = updater.thread_count() + 1;           // calling thread takes part too
+
+    for (auto& regions : passRegions)
+    {
+        if (regions.empty())
+            continue;
+
+        // hand out the biggest regions first, always to the least loaded part
+        std::vector<std::vector<WorldObject*>*> sortedRegions;
+        sortedRegions.reserve(regions.size());
+        for (auto& region : regions)
+            sortedRegions.push_back(&region.second);
+        std::sort(sortedRegions.begin(), sortedRegions.end(), [](std::vector<WorldObject*> const* a, std::vector<WorldObject*> const* b) { return a->size() > b->size(); });
+
+        std::vector<std::vector<WorldObject*>> parts(std::min(maxParts, sortedRegions.size()));
+        for (std::vector<WorldObject*>* region : sortedRegions)
+        {
+            auto& part = *std::min_element(parts.begin(), parts.end(), [](std::vector<WorldObject*> const& a, std::vector<WorldObject*> const& b) { return a.size() < b.size(); });
+            part.insert(part.end(), region->begin(), region->end());
+        }
+
+        WorkerBatch batch(parts.size());
+        std::vector<ObjectUpdateWorker> partWorkers;
+        std::vector<Worker*> workers;
+        partWorkers.reserve(parts.size());
+        workers.reserve(parts.size());
+        for (auto& part : parts)
+        {
+            partWorkers.emplace_back(part, diff, batch, updater);
+            workers.push_back(&partWorkers.back());
+        }
+
+        m_dyn_tree.balance();
+
+        m_parallelObjectUpdate = true;
+        updater.execute_batch(workers, batch);
+        m_parallelObjectUpdate = false;
+
+        // merge phase, all regions are done so objects may now change grid
+        ProcessDeferredRegionActions();
+    }
+}
+
+void Map::DeferRegionAction(std::function<void()>&& action)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_parallelUpdateLock);
+    m_deferredRegionActions.push_back(std::move(action));
+}
+
+void Map::ProcessDeferredRegionActions()
+{
+    std::vector<std::function<void()>> actions;
+    std::swap(actions, m_deferredRegionActions);
+
+    for (auto& action : actions)
+        action();
+}
+
 void Map::Remove(Player* player, bool remove)
 {
     if (i_data)
@@ -1014,6 +1246,13 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     Cell new_cell(new_val);
     bool same_cell = (new_cell == old_cell);
 
+    // grid change would touch a region updated by another thread
+    if (m_parallelObjectUpdate && old_cell.DiffGrid(new_cell))
+    {
+        DeferRegionAction([=]() { PlayerRelocation(player, x, y, z, orientation); });
+        return;
+    }
+
     player->Relocate(x, y, z, orientation);
 
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
@@ -1045,6 +1284,13 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
 {
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
 
+    // grid change would touch a region updated by another thread
+    if (m_parallelObjectUpdate && creature->GetCurrentCell().DiffGrid(new_cell))
+    {
+        DeferRegionAction([=]() { CreatureRelocation(creature, x, y, z, ang); });
+        return;
+    }
+
     // do move or do move to respawn or remove creature if previous all fail
     if (CreatureCellRelocation(creature, new_cell))
     {
@@ -1066,6 +1312,13 @@ void Map::GameObjectRelocation(GameObject* go, float x, float y, float z, float
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
     Cell old_cell = go->GetCurrentCell();
 
+    // grid change would touch a region updated by another thread
+    if (m_parallelObjectUpdate && old_cell.DiffGrid(new_cell))
+    {
+        DeferRegionAction([=]() { GameObjectRelocation(go, x, y, z, orientation, respawnRelocationOnFail); });
+        return;
+    }
+
     if (!respawnRelocationOnFail && !getNGrid(new_cell.GridX(), new_cell.GridY()))
         return;
 
@@ -1099,6 +1352,13 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
     Cell old_cell = dynObj->GetCurrentCell();
 
+    // grid change would touch a region updated by another thread
+    if (m_parallelObjectUpdate && old_cell.DiffGrid(new_cell))
+    {
+        DeferRegionAction([=]() { DynamicObjectRelocation(dynObj, x, y, z, orientation); });
+        return;
+    }
+
     if (!getNGrid(new_cell.GridX(), new_cell.GridY()))
         return;
 
@@ -1509,6 +1769,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
 
+    auto guard = GetParallelUpdateGuard();
     i_objectsToRemove.insert(obj);
     // DEBUG_LOG("Object (GUID: %u TypeId: %u ) added to removing list.",obj->GetGUIDLow(),obj->GetTypeId());
 }
@@ -1622,6 +1883,7 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    auto guard = GetParallelUpdateGuard();
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
@@ -1650,6 +1912,8 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    auto guard = GetParallelUpdateGuard();
+
     // Map::Update for active object in proccess
     if (m_activeNonPlayersIter != m_activeNonPlayers.end())
     {
@@ -2208,6 +2472,7 @@ bool Map::ScriptsStart(ScriptMapType scriptType, uint32 id, Object* source, Obje
 
     if (execParams)                                         // Check if the execution should be uniquely
     {
+        auto guard = GetParallelUpdateGuard();
         for (ScriptScheduleMap::const_iterator searchItr = m_scriptSchedule.begin(); searchItr != m_scriptSchedule.end(); ++searchItr)
         {
             if (searchItr->second.IsSameScript(scriptMapMap->first, id,
@@ -2240,6 +2505,7 @@ bool Map::ScriptsStart(ScriptMapType scriptType, uint32 id, Object* source, Obje
     }
 
     // add delayed script to script scheduler
+    auto guard = GetParallelUpdateGuard();
     for (; scriptInfoItr != scriptMap.end(); ++scriptInfoItr)
     {
         auto const& scriptInfo = scriptInfoItr->second;
@@ -2263,6 +2529,7 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 
     if (delay)
     {
+        auto guard = GetParallelUpdateGuard();
         m_scriptSchedule.emplace(GetCurrentClockTime() + std::chrono::milliseconds(delay), sa);
     }
     else
@@ -2325,6 +2592,7 @@ Player* Map::GetPlayer(ObjectGuid guid)
  */
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    auto guard = GetParallelUpdateGuard();
     return m_objectsStore.find<Creature>(guid, (Creature*)nullptr);
 }
 
@@ -2335,6 +2603,7 @@ Creature* Map::GetCreature(ObjectGuid guid)
  */
 Pet* Map::GetPet(ObjectGuid guid)
 {
+    auto guard = GetParallelUpdateGuard();
     return m_objectsStore.find<Pet>(guid, (Pet*)nullptr);
 }
 
@@ -2376,6 +2645,7 @@ Creature* Map::GetAnyTypeCreature(ObjectGuid guid)
  */
 GameObject* Map::GetGameObject(ObjectGuid guid)
 {
+    auto guard = GetParallelUpdateGuard();
     return m_objectsStore.find<GameObject>(guid, (GameObject*)nullptr);
 }
 
@@ -2386,6 +2656,7 @@ GameObject* Map::GetGameObject(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    auto guard = GetParallelUpdateGuard();
     return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)nullptr);
 }
 
@@ -2443,6 +2714,13 @@ void Map::SendObjectUpdates()
         obj->BuildUpdateData(update_players);
     }
 
+    uint32 parallelMinReceivers = sWorld.getConfig(CONFIG_UINT32_COMPRESSION_PARALLEL_MIN_RECEIVERS);
+    if (parallelMinReceivers && update_players.size() >= parallelMinReceivers && sMapMgr.GetUpdater().activated())
+    {
+        SendObjectUpdatesInParallel(update_players);
+        return;
+    }
+
     for (auto& update_player : update_players)
     {
         for (size_t i = 0; i < update_player.second.GetPacketCount(); ++i)
@@ -2453,6 +2731,36 @@ void Map::SendObjectUpdates()
     }
 }
 
+void Map::SendObjectUpdatesInParallel(UpdateDataMapType& update_players)
+{
+    // packets are built and compressed on all threads, every receiver's packets are still sent in order by the map
+    UpdatePacketWorker::Receivers receivers;
+    receivers.reserve(update_players.size());
+    for (auto& update_player : update_players)
+        receivers.emplace_back(update_player.first, &update_player.second);
+
+    std::vector<std::vector<WorldPacket>> packets(receivers.size());
+
+    MapUpdater& updater = sMapMgr.GetUpdater();
+    size_t partCount = std::min(receivers.size(), updater.thread_count() + 1);
+    WorkerBatch batch(partCount);
+    std::vector<UpdatePacketWorker> partWorkers;
+    std::vector<Worker*> workers;
+    partWorkers.reserve(partCount);
+    workers.reserve(partCount);
+    for (size_t i = 0; i < partCount; ++i)
+    {
+        partWorkers.emplace_back(receivers, packets, receivers.size() * i / partCount, receivers.size() * (i + 1) / partCount, batch, updater);
+        workers.push_back(&partWorkers.back());
+    }
+
+    updater.execute_batch(workers, batch);
+
+    for (size_t i = 0; i < receivers.size(); ++i)
+        for (WorldPacket const& packet : packets[i])
+            receivers[i].first->GetSession()->SendPacket(packet);
+}
+
 Creature* Map::GetCreature(uint32 dbguid) const
 {
     auto itr = m_dbGuidObjects.find(std::make_pair(HIGHGUID_UNIT, dbguid));
@@ -2544,17 +2852,20 @@ GameObject* Map::GetGameObject(std::string stringId) const
 
 void Map::AddDbGuidObject(WorldObject* obj)
 {
+    auto guard = GetParallelUpdateGuard();
     m_dbGuidObjects[std::make_pair(HighGuid(obj->GetParentHigh()), obj->GetDbGuid())].push_back(obj);
 }
 
 void Map::RemoveDbGuidObject(WorldObject* obj)
 {
+    auto guard = GetParallelUpdateGuard();
     auto& vec = m_dbGuidObjects[std::make_pair(HighGuid(obj->GetParentHigh()), obj->GetDbGuid())];
     vec.erase(std::remove(vec.begin(), vec.end(), obj), vec.end());
 }
 
 void Map::AddStringIdObject(uint32 stringId, WorldObject* obj)
 {
+    auto guard = GetParallelUpdateGuard();
     auto& data = m_objectsPerStringId[stringId];
     data.worldObjects.push_back(obj);
     if (obj->IsCreature())
@@ -2565,6 +2876,7 @@ void Map::AddStringIdObject(uint32 stringId, WorldObject* obj)
 
 void Map::RemoveStringIdObject(uint32 stringId, WorldObject* obj)
 {
+    auto guard = GetParallelUpdateGuard();
     auto& data = m_objectsPerStringId[stringId];
     data.worldObjects.erase(std::remove(data.worldObjects.begin(), data.worldObjects.end(), obj), data.worldObjects.end());
     if (obj->IsCreature())
@@ -2697,8 +3009,21 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    auto staticQuery = [&]()
+    {
+        return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model);
+    };
+    auto dynamicQuery = [&]()
+    {
+        auto guard = GetDynamicTreeReadGuard();
+        return m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    };
+
+    if (!m_collisionCache.IsEnabled())
+        return staticQuery() && dynamicQuery();
+
+    return m_collisionCache.IsInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model,
+                                            m_TerrainData->GetCollisionGeneration(srcX, srcY, destX, destY), staticQuery, dynamicQuery);
 }
 
 /**
@@ -2718,6 +3043,7 @@ bool Map::GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float
         destZ = tempZ;
     }
     // at second all dynamic objects, if static check has an hit, then we can calculate only to this closer point
+    auto guard = GetDynamicTreeReadGuard();
     bool result1 = m_dyn_tree.getObjectHitPos(phasemask, srcX, srcY, srcZ, destX, destY, destZ, tempX, tempY, tempZ, modifyDist);
     if (result1)
     {
@@ -2781,31 +3107,62 @@ bool Map::GetHeightInRange(uint32 phasemask, float x, float y, float& z, float m
             return false;
     }
 
+    auto guard = GetDynamicTreeReadGuard();
     z = std::max<float>(height, m_dyn_tree.getHeight(x, y, height + 1.0f, maxSearchDist, phasemask));
     return true;
 }
 
 float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool swim) const
 {
-    float staticHeight = m_TerrainData->GetHeightStatic(x, y, z, true, (swim ? DEFAULT_WATER_SEARCH : DEFAULT_HEIGHT_SEARCH));
-
+    auto staticQuery = [&]()
+    {
+        return m_TerrainData->GetHeightStatic(x, y, z, true, (swim ? DEFAULT_WATER_SEARCH : DEFAULT_HEIGHT_SEARCH));
+    };
     // Get Dynamic Height around static Height (if valid)
-    float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
-    return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight, phasemask));
+    auto dynamicQuery = [&](float staticHeight)
+    {
+        float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
+        auto guard = GetDynamicTreeReadGuard();
+        return m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight, phasemask);
+    };
+
+    if (!m_collisionCache.IsEnabled())
+    {
+        float staticHeight = staticQuery();
+        return std::max<float>(staticHeight, dynamicQuery(staticHeight));
+    }
+
+    return m_collisionCache.GetHeight(x, y, z, phasemask, swim, m_TerrainData->GetCollisionGeneration(x, y, x, y), staticQuery, dynamicQuery);
 }
 
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
+    auto guard = GetDynamicTreeWriteGuard();
     m_dyn_tree.insert(mdl);
+    // queries balance the tree on demand, which would write to it from several threads
+    if (m_parallelObjectUpdate)
+        m_dyn_tree.balance();
+    OnGameObjectModelChanged(mdl);
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
+    auto guard = GetDynamicTreeWriteGuard();
     m_dyn_tree.remove(mdl);
+    if (m_parallelObjectUpdate)
+        m_dyn_tree.balance();
+    OnGameObjectModelChanged(mdl);
+}
+
+void Map::OnGameObjectModelChanged(const GameObjectModel& mdl)
+{
+    G3D::AABox const& bounds = mdl.getBounds();
+    m_collisionCache.InvalidateDynamic(bounds.low().x, bounds.low().y, bounds.high().x, bounds.high().y);
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
 {
+    auto guard = GetDynamicTreeReadGuard();
     return m_dyn_tree.contains(mdl);
 }
 
@@ -3022,11 +3379,13 @@ uint32 Map::SpawnedCountForEntry(uint32 entry)
 
 void Map::AddToSpawnCount(const ObjectGuid& guid)
 {
+    auto guard = GetParallelUpdateGuard();
     m_spawnedCount[guid.GetEntry()].insert(guid);
 }
 
 void Map::RemoveFromSpawnCount(const ObjectGuid& guid)
 {
+    auto guard = GetParallelUpdateGuard();
     m_spawnedCount[guid.GetEntry()].erase(guid);
 }
 
@@ -38,11 +38,14 @@
 #include "Globals/GraveyardManager.h"
 #include "Maps/SpawnManager.h"
 #include "Maps/MapDataContainer.h"
+#include "Maps/CollisionCache.h"
 #include "World/WorldStateVariableManager.h"
 
 #include <bitset>
 #include <functional>
 #include <list>
+#include <mutex>
+#include <shared_mutex>
 
 struct CreatureInfo;
 class Creature;
@@ -323,19 +326,53 @@ class Map : public GridRefManager<NGridType>
 
         typedef TypeUnorderedMapContainer<AllMapStoredObjectTypes, ObjectGuid> MapStoredObjectTypesContainer;
         MapStoredObjectTypesContainer& GetObjectsStore() { return m_objectsStore; }
+        template<class T> void InsertObject(ObjectGuid guid, T* obj)
+        {
+            auto guard = GetParallelUpdateGuard();
+            m_objectsStore.insert<T>(guid, obj);
+        }
+        template<class T> void EraseObject(ObjectGuid guid, T* obj)
+        {
+            auto guard = GetParallelUpdateGuard();
+            m_objectsStore.erase<T>(guid, obj);
+        }
         std::map<uint32, uint32>& GetTempCreatures() { return m_tempCreatures; }
         std::map<uint32, uint32>& GetTempPets() { return m_tempPets; }
 
         void AddUpdateObject(Object* obj)
         {
+            auto guard = GetParallelUpdateGuard();
             i_objectsToClientUpdate.insert(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
+            auto guard = GetParallelUpdateGuard();
             i_objectsToClientUpdate.erase(obj);
         }
 
+        // true while regions of this map are updated by several threads (MapUpdate.ParallelObjectUpdate)
+        bool IsUpdatingObjectsInParallel() const { return m_parallelObjectUpdate; }
+        // serializes access to map wide containers during parallel object update, does nothing otherwise
+        std::unique_lock<std::recursive_mutex> GetParallelUpdateGuard()
+        {
+            return m_parallelObjectUpdate ? std::unique_lock<std::recursive_mutex>(m_parallelUpdateLock) : std::unique_lock<std::recursive_mutex>();
+        }
+        // dynamic tree access, the tree is kept balanced while objects are updated in parallel so readers don't write to it
+        std::shared_lock<std::shared_mutex> GetDynamicTreeReadGuard() const
+        {
+            return m_parallelObjectUpdate ? std::shared_lock<std::shared_mutex>(m_dynTreeLock) : std::shared_lock<std::shared_mutex>();
+        }
+        std::unique_lock<std::shared_mutex> GetDynamicTreeWriteGuard()
+        {
+            return m_parallelObjectUpdate ? std::unique_lock<std::shared_mutex>(m_dynTreeLock) : std::unique_lock<std::shared_mutex>();
+        }
+        // serializes instance data, zone script and AI callbacks during parallel object update, does nothing otherwise
+        std::unique_lock<std::recursive_mutex> GetScriptGuard()
+        {
+            return m_parallelObjectUpdate ? std::unique_lock<std::recursive_mutex>(m_scriptLock) : std::unique_lock<std::recursive_mutex>();
+        }
+
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
 
@@ -360,6 +397,8 @@ class Map : public GridRefManager<NGridType>
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // drops cached collision results around a model that was added, removed, toggled or changed phase
+        void OnGameObjectModelChanged(const GameObjectModel& mdl);
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -404,6 +443,10 @@ class Map : public GridRefManager<NGridType>
 
         Messager<Map>& GetMessager() { return m_messager; }
 
+        // duration of the last update in microseconds, used to start the most expensive maps first
+        uint32 GetLastUpdateCost() const { return m_lastUpdateCost; }
+        void SetLastUpdateCost(uint32 cost) { m_lastUpdateCost = cost; }
+
         typedef std::set<Transport*> TransportSet;
         GenericTransport* GetTransport(ObjectGuid guid);
         TransportSet const& GetTransports() { return m_transports; }
@@ -440,6 +483,8 @@ class Map : public GridRefManager<NGridType>
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        // request grid data ahead of players moving towards unloaded grids
+        void UpdateGridPreload(uint32 diff);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -472,8 +517,16 @@ class Map : public GridRefManager<NGridType>
         void ScriptsProcess();
 
         void SendObjectUpdates();
+        void SendObjectUpdatesInParallel(UpdateDataMapType& update_players);
         std::set<Object*> i_objectsToClientUpdate;
 
+        bool CanUpdateObjectsInParallel(size_t objectCount) const;
+        static bool CanUpdateObjectInParallel(WorldObject const* obj);
+        void UpdateObjectsInParallel(WorldObjectUnSet& objToUpdate, uint32 diff);
+        // queues an action which can't be done while regions are updated, it is executed at end of the pass
+        void DeferRegionAction(std::function<void()>&& action);
+        void ProcessDeferredRegionActions();
+
     protected:
         MapEntry const* i_mapEntry;
         uint8 i_spawnMode;
@@ -541,6 +594,7 @@ class Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+        mutable MapCollisionCache m_collisionCache;
 
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
@@ -575,6 +629,19 @@ class Map : public GridRefManager<NGridType>
         TimePoint m_dynamicDifficultyCooldown;
 
         std::map<std::pair<uint32, uint32>, uint32> m_tileNumberPerTile;
+
+        uint32 m_lastUpdateCost;
+
+        // grid preloading
+        uint32 m_gridPreloadTimer;
+        std::map<ObjectGuid, Position> m_gridPreloadPositions;  // player positions at the previous prediction
+
+        // parallel object update
+        bool m_parallelObjectUpdate;
+        std::recursive_mutex m_parallelUpdateLock;
+        std::recursive_mutex m_scriptLock;
+        mutable std::shared_mutex m_dynTreeLock;                // dynamic tree readers vs model changes during parallel object update
+        std::vector<std::function<void()>> m_deferredRegionActions;
 };
 
 class WorldMap : public Map
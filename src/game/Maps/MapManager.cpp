@@ -34,7 +34,7 @@ INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, std::recursive_mutex);
 
 MapManager::MapManager()
-    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), m_updateScheduled(false)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -183,6 +183,7 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
         {
             i_maps.erase(iter);
 
+            m_gridPreloader.Cancel(pMap->GetId(), pMap->GetInstanceId());
             pMap->UnloadAll(true);
             delete pMap;
         }
@@ -190,18 +191,52 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
 }
 
 void MapManager::Update(uint32 diff)
+{
+    ScheduleUpdate(diff);
+    FinishUpdate();
+}
+
+void MapManager::ScheduleUpdate(uint32 diff)
 {
     i_timer.Update(diff);
-    if (!i_timer.Passed())
+    m_updateScheduled = i_timer.Passed();
+    if (!m_updateScheduled)
         return;
 
-    for (auto& map : i_maps)
+    if (m_updater.activated())
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
-        else
+        // most expensive maps of the last tick are started first, so none of them is left as the tail of the update
+        std::vector<Map*> maps;
+        maps.reserve(i_maps.size());
+        for (auto& map : i_maps)
+            maps.push_back(map.second);
+        std::sort(maps.begin(), maps.end(), [](Map const* a, Map const* b) { return a->GetLastUpdateCost() > b->GetLastUpdateCost(); });
+
+        while (m_updateWorkers.size() < maps.size())
+            m_updateWorkers.push_back(std::make_unique<MapUpdateWorker>(m_updater));
+
+        m_scheduledWorkers.clear();
+        for (size_t i = 0; i < maps.size(); ++i)
+        {
+            m_updateWorkers[i]->Reset(*maps[i], (uint32)i_timer.GetCurrent());
+            m_scheduledWorkers.push_back(m_updateWorkers[i].get());
+        }
+
+        m_updater.schedule_updates(m_scheduledWorkers);
+    }
+    else
+    {
+        for (auto& map : i_maps)
             map.second->Update((uint32)i_timer.GetCurrent());
     }
+}
+
+void MapManager::FinishUpdate()
+{
+    if (!m_updateScheduled)
+        return;
+
+    m_updateScheduled = false;
 
     if (m_updater.activated())
         m_updater.wait();
@@ -214,6 +249,7 @@ void MapManager::Update(uint32 diff)
         // check if map can be unloaded
         if (pMap->CanUnload((uint32)i_timer.GetCurrent()))
         {
+            m_gridPreloader.Cancel(pMap->GetId(), pMap->GetInstanceId());
             pMap->UnloadAll(true);
             delete pMap;
 
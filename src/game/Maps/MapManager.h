@@ -26,11 +26,15 @@
 #include "Maps/Map.h"
 #include "Grids/GridStates.h"
 #include "Maps/MapUpdater.h"
+#include "Maps/GridPreloader.h"
 
 #include <functional>
+#include <memory>
 
 class Transport;
 class BattleGround;
+class Worker;
+class MapUpdateWorker;
 struct TransportTemplate;
 
 struct MapID
@@ -75,6 +79,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         void Initialize();
         void Update(uint32);
+        // split form of Update: maps run on the updater threads between the two calls
+        void ScheduleUpdate(uint32);
+        void FinishUpdate();
 
         void SetGridCleanUpDelay(uint32 t)
         {
@@ -149,6 +156,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         // get list of all maps
         const MapMapType& Maps() const { return i_maps; }
 
+        MapUpdater& GetUpdater() { return m_updater; }
+        GridPreloader& GetGridPreloader() { return m_gridPreloader; }
+
         template<typename Do> void DoForAllMaps(Do& _do)
         {
             for (auto& mapData : i_maps)
@@ -188,6 +198,11 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         IntervalTimer i_timer;
 
         MapUpdater m_updater;
+        std::vector<std::unique_ptr<MapUpdateWorker>> m_updateWorkers;
+        std::vector<Worker*> m_scheduledWorkers;
+        bool m_updateScheduled;
+
+        GridPreloader m_gridPreloader;
 };
 
 template<typename Do>
@@ -45,7 +45,7 @@ static uint32 resetEventTypeDelay[MAX_RESET_EVENT_TYPE] = { 0,
 //== MapPersistentState functions ==========================
 MapPersistentState::MapPersistentState(uint16 MapId, uint32 InstanceId, Difficulty difficulty)
     : m_instanceid(InstanceId), m_mapid(MapId),
-      m_difficulty(difficulty), m_usedByMap(nullptr)
+      m_difficulty(difficulty), m_usedByMap(nullptr), m_respawnTimeResets(0)
 {
 }
 
@@ -134,6 +134,10 @@ void MapPersistentState::SaveObjectRespawnTime(uint32 typeId, uint32 loguid, tim
 
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 {
+    RespawnTimes::const_iterator itr = m_creatureRespawnTimes.find(loguid);
+    if (itr != m_creatureRespawnTimes.end() && t < itr->second && itr->second > sWorld.GetGameTime())
+        ++m_respawnTimeResets;
+
     if (t > sWorld.GetGameTime())
         m_creatureRespawnTimes[loguid] = t;
     else
@@ -145,6 +149,10 @@ void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 
 void MapPersistentState::SetGORespawnTime(uint32 loguid, time_t t)
 {
+    RespawnTimes::const_iterator itr = m_goRespawnTimes.find(loguid);
+    if (itr != m_goRespawnTimes.end() && t < itr->second && itr->second > sWorld.GetGameTime())
+        ++m_respawnTimeResets;
+
     if (t > sWorld.GetGameTime())
         m_goRespawnTimes[loguid] = t;
     else
@@ -158,6 +166,7 @@ void MapPersistentState::ClearRespawnTimes()
 {
     m_goRespawnTimes.clear();
     m_creatureRespawnTimes.clear();
+    ++m_respawnTimeResets;
 
     UnloadIfEmpty();
 }
@@ -103,6 +103,8 @@ class MapPersistentState
         void SaveGORespawnTime(uint32 loguid, time_t t);
         time_t GetObjectRespawnTime(uint32 typeId, uint32 loguid) const;
         void SaveObjectRespawnTime(uint32 typeId, uint32 loguid, time_t t);
+        // changes whenever a pending respawn time is shortened or cleared
+        uint32 GetRespawnTimeResets() const { return m_respawnTimeResets; }
 
         // pool system
         void InitPools();
@@ -143,6 +145,7 @@ class MapPersistentState
         // persistent data
         RespawnTimes m_creatureRespawnTimes;                // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
+        uint32 m_respawnTimeResets;
         MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
 
         SpawnedPoolData m_spawnedPoolData;                  // Pools spawns state for map copy
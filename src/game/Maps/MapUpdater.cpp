@@ -19,10 +19,17 @@
 #include "MapUpdater.h"
 #include "MapWorkers.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+#include <cstdint>
+
+namespace
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    // queue owned by the current thread, threads outside of the pool have none
+    thread_local size_t t_ownQueue = SIZE_MAX;
+}
+
+MapUpdater::MapUpdater(size_t num_threads) : MapUpdater()
+{
+    activate(num_threads);
 }
 
 void MapUpdater::activate(size_t num_threads)
@@ -30,25 +37,36 @@ void MapUpdater::activate(size_t num_threads)
     if (activated())
         return;
 
+    _cancelationToken = false;
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _queues.push_back(std::make_unique<WorkQueue>());
+
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_idleLock);
+        _cancelationToken = true;
+    }
+    _idleCondition.notify_all();
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    _workerThreads.clear();
+    _queues.clear();
+    _queued = 0;
 }
 
 void MapUpdater::wait()
 {
     std::unique_lock<std::mutex> lock(_lock);
 
-    while (pending_requests > 0)
+    while (_pending > 0)
         _condition.wait(lock);
 }
 
@@ -65,36 +83,160 @@ bool MapUpdater::activated()
 
 void MapUpdater::update_finished()
 {
-    std::lock_guard<std::mutex> lock(_lock);
-
-    --pending_requests;
-    _condition.notify_all();
+    if (--_pending == 0)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _condition.notify_all();
+    }
 }
 
 void MapUpdater::schedule_update(Worker* worker)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    ++_pending;
+    push(_nextQueue++ % _queues.size(), worker, false);
+    notify_queued(1);
+}
 
-    ++pending_requests;
-    _queue.Push(std::move(worker));
+void MapUpdater::schedule_updates(std::vector<Worker*> const& workers)
+{
+    if (workers.empty())
+        return;
+
+    // round robin keeps the most expensive jobs at the front of every queue
+    _pending += workers.size();
+    size_t first = _nextQueue;
+    for (size_t i = 0; i < workers.size(); ++i)
+        push((first + i) % _queues.size(), workers[i], false);
+    _nextQueue += workers.size();
+
+    notify_queued(workers.size());
 }
 
-void MapUpdater::WorkerThread()
+void MapUpdater::execute_batch(std::vector<Worker*> const& workers, WorkerBatch& batch)
 {
-    while (true)
+    if (workers.empty())
+        return;
+
+    // parts of a batch are what their caller waits for, so they go in front of everything else
+    size_t own = t_ownQueue;
+    for (size_t i = 1; i < workers.size(); ++i)
+        push((own + i) % _queues.size(), workers[i], true);
+    notify_queued(workers.size() - 1);
+
+    // first part is always done by the calling thread
+    workers[0]->execute();
+
+    while (batch.pending > 0)
     {
         Worker* request = nullptr;
+        if (pop(own, request) || steal(own, request))
+        {
+            request->execute();
+            continue;
+        }
+
+        // all remaining parts are already processed by other threads
+        std::unique_lock<std::mutex> lock(batch.lock);
+        while (batch.pending > 0)
+            batch.condition.wait(lock);
+    }
+
+    // last finisher may still hold the lock, batch must outlive it
+    std::lock_guard<std::mutex> lock(batch.lock);
+}
+
+void MapUpdater::batch_finished(WorkerBatch& batch)
+{
+    std::lock_guard<std::mutex> lock(batch.lock);
 
-        _queue.WaitAndPop(request);
+    if (--batch.pending == 0)
+        batch.condition.notify_all();
+}
 
-        if (_cancelationToken)
+void MapUpdater::push(size_t queue, Worker* worker, bool front)
+{
+    WorkQueue& workQueue = *_queues[queue];
+    std::lock_guard<std::mutex> lock(workQueue.lock);
+
+    if (front)
+        workQueue.jobs.push_front(worker);
+    else
+        workQueue.jobs.push_back(worker);
+    ++_queued;
+}
+
+bool MapUpdater::pop(size_t queue, Worker*& worker)
+{
+    if (queue >= _queues.size())
+        return false;
+
+    WorkQueue& workQueue = *_queues[queue];
+    std::lock_guard<std::mutex> lock(workQueue.lock);
+
+    if (workQueue.jobs.empty())
+        return false;
+
+    worker = workQueue.jobs.front();
+    workQueue.jobs.pop_front();
+    --_queued;
+    return true;
+}
+
+bool MapUpdater::steal(size_t thief, Worker*& worker)
+{
+    for (size_t i = 1; i <= _queues.size(); ++i)
+    {
+        size_t victim = (thief + i) % _queues.size();
+        if (victim == thief)
+            continue;
+
+        WorkQueue& workQueue = *_queues[victim];
+        std::lock_guard<std::mutex> lock(workQueue.lock);
+
+        // cheapest job is at the back
+        if (workQueue.jobs.empty())
+            continue;
+
+        worker = workQueue.jobs.back();
+        workQueue.jobs.pop_back();
+        --_queued;
+        return true;
+    }
+
+    return false;
+}
+
+void MapUpdater::notify_queued(size_t count)
+{
+    if (!count)
+        return;
+
+    // sleepers check _queued under this lock, so taking it here can't lose a wakeup
+    {
+        std::lock_guard<std::mutex> lock(_idleLock);
+    }
+
+    if (count == 1)
+        _idleCondition.notify_one();
+    else
+        _idleCondition.notify_all();
+}
+
+void MapUpdater::WorkerThread(size_t index)
+{
+    t_ownQueue = index;
+
+    while (!_cancelationToken)
+    {
+        Worker* request = nullptr;
+        if (pop(index, request) || steal(index, request))
         {
-            delete request;
-            return;
+            request->execute();
+            continue;
         }
 
-        request->execute();
-
-        delete request;
+        std::unique_lock<std::mutex> lock(_idleLock);
+        while (_queued == 0 && !_cancelationToken)
+            _idleCondition.wait(lock);
     }
-}
\ No newline at end of file
+}
@@ -20,23 +20,36 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Platform/Define.h"
-#include "Util/ProducerConsumerQueue.h"
 
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 
 class Worker;
 
+// completion counter of a group of workers started with MapUpdater::execute_batch
+struct WorkerBatch
+{
+    WorkerBatch(size_t count) : pending(count) {}
+
+    std::atomic<size_t> pending;
+    std::mutex lock;
+    std::condition_variable condition;
+};
+
+// Every thread owns a deque of jobs, jobs are taken from its front and idle threads steal from the back
+// of the others. Workers are never owned by the updater, the scheduling side keeps them alive until done.
 class MapUpdater
 {
     public:
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _cancelationToken(false), _queued(0), _pending(0), _nextQueue(0) {}
         MapUpdater(size_t num_threads);
         MapUpdater(const MapUpdater&) = delete;
-        
+
         void activate(size_t num_threads);
         void deactivate();
         void wait();
@@ -44,18 +57,42 @@ class MapUpdater
         bool activated();
         void update_finished();
         void schedule_update(Worker* worker);
+        // workers are expected to be sorted by expected cost, most expensive first
+        void schedule_updates(std::vector<Worker*> const& workers);
+        // runs all workers on the pool and returns once they are finished, the calling thread helps
+        // processing the queues meanwhile so it is safe to be used from inside a map update worker
+        void execute_batch(std::vector<Worker*> const& workers, WorkerBatch& batch);
+        void batch_finished(WorkerBatch& batch);
+        size_t thread_count() const { return _workerThreads.size(); }
 
     private:
-        ProducerConsumerQueue<Worker *> _queue;
+        struct WorkQueue
+        {
+            std::mutex lock;
+            std::deque<Worker*> jobs;
+        };
 
+        std::vector<std::unique_ptr<WorkQueue>> _queues;
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
 
+        // idle threads sleep here until something is queued
+        std::mutex _idleLock;
+        std::condition_variable _idleCondition;
+        std::atomic<size_t> _queued;
+
+        // latch of scheduled updates, waiters are only woken when it drops to zero
         std::mutex _lock;
         std::condition_variable _condition;
-        size_t pending_requests;
+        std::atomic<size_t> _pending;
+
+        std::atomic<size_t> _nextQueue;
 
-        void WorkerThread();
+        void push(size_t queue, Worker* worker, bool front);
+        bool pop(size_t queue, Worker*& worker);
+        bool steal(size_t thief, Worker*& worker);
+        void notify_queued(size_t count);
+        void WorkerThread(size_t index);
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
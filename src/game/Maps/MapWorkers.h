@@ -24,8 +24,12 @@
 #include "MapUpdater.h"
 #include "MotionGenerators/MovementGenerator.h"
 #include "Entities/Object.h"
+#include "Entities/UpdateData.h"
+#include "Server/WorldPacket.h"
 #include "Platform/Define.h"
 
+#include <chrono>
+
 class Worker
 {
     public:
@@ -40,21 +44,30 @@ class Worker
         MapUpdater& m_updater;
 };
 
+// one per map, kept in a pool by MapManager and reused every tick
 class MapUpdateWorker : public Worker
 {
     public:
-        MapUpdateWorker(Map& map, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_diff(diff)
+        MapUpdateWorker(MapUpdater& updater) :
+            Worker(updater), m_map(nullptr), m_diff(0)
         {}
 
+        void Reset(Map& map, uint32 diff)
+        {
+            m_map = &map;
+            m_diff = diff;
+        }
+
         void execute() override
         {
-            m_map.Update(m_diff);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            m_map->Update(m_diff);
+            m_map->SetLastUpdateCost(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
             GetWorker().update_finished();
         }
 
     private:
-        Map& m_map;
+        Map* m_map;
         uint32 m_diff;
 };
 
@@ -91,21 +104,53 @@ class GridCrawler : public Worker
 class ObjectUpdateWorker : public Worker
 {
     public:
-        ObjectUpdateWorker(std::unordered_set<WorldObject*>& objects, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_objects(objects), m_diff(diff)
+        ObjectUpdateWorker(std::vector<WorldObject*>& objects, uint32 diff, WorkerBatch& batch, MapUpdater& updater) :
+            Worker(updater), m_objects(objects), m_diff(diff), m_batch(batch)
         {}
 
         void execute() override
         {
-            for (WorldObject* const &object : m_objects)
+            for (WorldObject* object : m_objects)
                 object->Update(m_diff);
 
-            GetWorker().update_finished();
+            GetWorker().batch_finished(m_batch);
         }
 
     private:
-        std::unordered_set<WorldObject*>& m_objects;
+        std::vector<WorldObject*>& m_objects;
         uint32 m_diff;
+        WorkerBatch& m_batch;
+};
+
+// builds and compresses the update packets of a range of receivers, sending stays with the map
+class UpdatePacketWorker : public Worker
+{
+    public:
+        typedef std::vector<std::pair<Player*, UpdateData*>> Receivers;
+
+        UpdatePacketWorker(Receivers& receivers, std::vector<std::vector<WorldPacket>>& packets, size_t begin, size_t end, WorkerBatch& batch, MapUpdater& updater) :
+            Worker(updater), m_receivers(receivers), m_packets(packets), m_begin(begin), m_end(end), m_batch(batch)
+        {}
+
+        void execute() override
+        {
+            for (size_t i = m_begin; i < m_end; ++i)
+            {
+                UpdateData& data = *m_receivers[i].second;
+                m_packets[i].reserve(data.GetPacketCount());
+                for (size_t j = 0; j < data.GetPacketCount(); ++j)
+                    m_packets[i].push_back(data.BuildPacket(j));
+            }
+
+            GetWorker().batch_finished(m_batch);
+        }
+
+    private:
+        Receivers& m_receivers;
+        std::vector<std::vector<WorldPacket>>& m_packets;
+        size_t m_begin;
+        size_t m_end;
+        WorkerBatch& m_batch;
 };
 
 #endif //_MAP_WORKERS_H_INCLUDED
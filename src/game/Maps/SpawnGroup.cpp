@@ -62,18 +62,20 @@ namespace
     }
 }
 
-SpawnGroup::SpawnGroup(SpawnGroupEntry const& entry, Map& map, uint32 typeId) : m_entry(entry), m_map(map), m_objectTypeId(typeId), m_enabled(m_entry.EnabledByDefault)
+SpawnGroup::SpawnGroup(SpawnGroupEntry const& entry, Map& map, uint32 typeId) : m_entry(entry), m_map(map), m_objectTypeId(typeId), m_enabled(m_entry.EnabledByDefault), m_nextSpawnCheck(0), m_respawnTimeResets(0)
 {
 }
 
 void SpawnGroup::AddObject(uint32 dbGuid, uint32 entry)
 {
     m_objects[dbGuid] = entry;
+    m_nextSpawnCheck = 0;
 }
 
 void SpawnGroup::RemoveObject(WorldObject* wo)
 {
     m_objects.erase(wo->GetDbGuid());
+    m_nextSpawnCheck = 0;
 
     if (!m_map.IsDungeon() && m_objects.empty() && m_entry.HasChancedSpawns)
     {
@@ -103,6 +105,13 @@ void SpawnGroup::Update()
     Spawn(false);
 }
 
+void SpawnGroup::DelaySpawnUntil(time_t respawnTime)
+{
+    // checked again earlier if any respawn time of the map is shortened meanwhile
+    m_nextSpawnCheck = respawnTime;
+    m_respawnTimeResets = m_map.GetPersistentState()->GetRespawnTimeResets();
+}
+
 uint32 SpawnGroup::GetEligibleEntry(std::map<uint32, uint32>& existingEntries, std::map<uint32, uint32>& minEntries)
 {
     if (m_entry.RandomEntries.empty())
@@ -165,6 +174,10 @@ void SpawnGroup::Spawn(bool force)
     if (m_objects.size() >= m_entry.MaxCount)
         return;
 
+    time_t now = time(nullptr);
+    if (!force && now < m_nextSpawnCheck && m_respawnTimeResets == m_map.GetPersistentState()->GetRespawnTimeResets())
+        return;
+
     if (!IsWorldstateConditionSatisfied())
         return;
 
@@ -205,15 +218,20 @@ void SpawnGroup::Spawn(bool force)
         }
     }
 
-    time_t now = time(nullptr);
+    time_t nextRespawnTime = std::numeric_limits<time_t>::max();
     for (auto itr = eligibleGuids.begin(); itr != eligibleGuids.end();)
     {
-        if (m_map.GetPersistentState()->GetObjectRespawnTime(GetObjectTypeId(), (*itr)->DbGuid) > now)
+        time_t respawnTime = m_map.GetPersistentState()->GetObjectRespawnTime(GetObjectTypeId(), (*itr)->DbGuid);
+        if (respawnTime > now)
         {
             if (!force)
             {
                 if (m_entry.MaxCount == 1) // rare mob case - prevent respawn until all are off CD
+                {
+                    DelaySpawnUntil(respawnTime);
                     return;
+                }
+                nextRespawnTime = std::min(nextRespawnTime, respawnTime);
                 itr = eligibleGuids.erase(itr);
                 continue;
             }
@@ -223,6 +241,12 @@ void SpawnGroup::Spawn(bool force)
         ++itr;
     }
 
+    if (eligibleGuids.empty() && nextRespawnTime != std::numeric_limits<time_t>::max())
+    {
+        DelaySpawnUntil(nextRespawnTime);
+        return;
+    }
+
     for (auto itr = eligibleGuids.begin(); itr != eligibleGuids.end();)
     {
         uint32 spawnMask = 0; // safeguarded on db load
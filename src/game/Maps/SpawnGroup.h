@@ -50,7 +50,7 @@ class SpawnGroup
         virtual void Despawn(uint32 timeMSToDespawn = 0, uint32 forcedDespawnTime = 0) = 0;
         std::string to_string() const;
         uint32 GetObjectTypeId() const { return m_objectTypeId; }
-        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        void SetEnabled(bool enabled) { m_enabled = enabled; m_nextSpawnCheck = 0; }
         SpawnGroupEntry const& GetGroupEntry() const { return m_entry; }
         uint32 GetGroupId() const { return m_entry.Id; }
 
@@ -61,6 +61,8 @@ class SpawnGroup
         void RespawnIfInVicinity(Position pos, float range);
 
     protected:
+        void DelaySpawnUntil(time_t respawnTime);
+
         SpawnGroupEntry const& m_entry;
         Map& m_map;
         std::map<uint32, uint32> m_objects;
@@ -68,6 +70,10 @@ class SpawnGroup
         std::map<uint32, bool> m_chosenSpawns;
         uint32 m_objectTypeId;
         bool m_enabled;
+
+        // all eligible guids wait for their respawn time, nothing to spawn before then
+        time_t m_nextSpawnCheck;
+        uint32 m_respawnTimeResets;
 };
 
 class CreatureGroup : public SpawnGroup
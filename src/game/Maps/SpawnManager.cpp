@@ -105,105 +105,109 @@ void SpawnManager::Initialize()
     }
 }
 
+SpawnInfo* SpawnManager::FindSpawn(uint32 dbguid, HighGuid high)
+{
+    auto itr = m_spawns.find(GetSpawnKey(dbguid, high));
+    if (itr == m_spawns.end() || itr->second.IsUsed())
+        return nullptr;
+
+    return &itr->second;
+}
+
+void SpawnManager::AddSpawn(SpawnInfo&& spawnInfo)
+{
+    if (m_updated) // cannot insert during update
+    {
+        m_deferredSpawns.push_back(std::move(spawnInfo));
+        return;
+    }
+
+    // a spawn has at most one pending respawn, a newer one replaces it
+    auto itr = m_spawns.insert_or_assign(GetSpawnKey(spawnInfo.GetDbGuid(), spawnInfo.GetHighGuid()), std::move(spawnInfo)).first;
+    ScheduleSpawn(itr->second);
+}
+
+void SpawnManager::ScheduleSpawn(SpawnInfo& spawnInfo)
+{
+    spawnInfo.SetScheduleId(++m_nextScheduleId);
+    m_spawnQueue.emplace(spawnInfo.GetRespawnTime(), GetSpawnKey(spawnInfo.GetDbGuid(), spawnInfo.GetHighGuid()), spawnInfo.GetScheduleId());
+}
+
+void SpawnManager::AddDeferredSpawns()
+{
+    std::vector<SpawnInfo> deferredSpawns;
+    std::swap(deferredSpawns, m_deferredSpawns);
+    for (auto& spawnInfo : deferredSpawns)
+        AddSpawn(std::move(spawnInfo));
+}
+
 void SpawnManager::AddCreature(uint32 dbguid)
 {
+    auto guard = m_map.GetParallelUpdateGuard();
     time_t respawnTime = m_map.GetPersistentState()->GetCreatureRespawnTime(dbguid);
-    if (m_updated)
-        m_deferredSpawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_UNIT);
-    else
-        m_spawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_UNIT);
+    AddSpawn(SpawnInfo(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_UNIT));
 }
 
 void SpawnManager::AddGameObject(uint32 dbguid)
 {
+    auto guard = m_map.GetParallelUpdateGuard();
     time_t respawnTime = m_map.GetPersistentState()->GetGORespawnTime(dbguid);
-    if (m_updated)
-        m_deferredSpawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_GAMEOBJECT);
-    else
-        m_spawns.emplace_back(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_GAMEOBJECT);
+    AddSpawn(SpawnInfo(TimePoint(std::chrono::seconds(respawnTime)), dbguid, HIGHGUID_GAMEOBJECT));
 }
 
 void SpawnManager::RespawnCreature(uint32 dbguid, uint32 respawnDelay)
 {
-    bool found = false;
-    auto itr = m_spawns.begin();
-    for (; itr != m_spawns.end(); )
-    {
-        auto& spawnInfo = *itr;
-        if (!spawnInfo.IsUsed() && spawnInfo.GetDbGuid() == dbguid && spawnInfo.GetHighGuid() == HIGHGUID_UNIT)
-        {
-            found = true;
-            m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
-            if (respawnDelay > 0)
-                spawnInfo.SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
-            break;
-        }
-        ++itr;
-    }
-    if (!found)
-    {
-        m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
+    auto guard = m_map.GetParallelUpdateGuard();
+    m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
+    SpawnInfo* spawnInfo = FindSpawn(dbguid, HIGHGUID_UNIT);
+    if (!spawnInfo)
         AddCreature(dbguid);
+    else if (respawnDelay > 0)
+    {
+        spawnInfo->SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
+        ScheduleSpawn(*spawnInfo);
     }
-    else if (respawnDelay == 0)
-        (*itr).ConstructForMap(m_map);
+    else
+        spawnInfo->ConstructForMap(m_map); // erased once its queue entry is reached
 }
 
 void SpawnManager::RespawnGameObject(uint32 dbguid, uint32 respawnDelay)
 {
-    bool found = false;
-    auto itr = m_spawns.begin();
-    for (; itr != m_spawns.end(); )
-    {
-        auto& spawnInfo = *itr;
-        if (!spawnInfo.IsUsed() && spawnInfo.GetDbGuid() == dbguid && spawnInfo.GetHighGuid() == HIGHGUID_GAMEOBJECT)
-        {
-            found = true;
-            m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
-            if (respawnDelay > 0)
-                spawnInfo.SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
-            break;
-        }
-        ++itr;
-    }
-    if (!found)
-    {
-        m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
+    auto guard = m_map.GetParallelUpdateGuard();
+    m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
+    SpawnInfo* spawnInfo = FindSpawn(dbguid, HIGHGUID_GAMEOBJECT);
+    if (!spawnInfo)
         AddGameObject(dbguid);
+    else if (respawnDelay > 0)
+    {
+        spawnInfo->SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
+        ScheduleSpawn(*spawnInfo);
     }
-    else if (respawnDelay == 0)
-        (*itr).ConstructForMap(m_map);
+    else
+        spawnInfo->ConstructForMap(m_map); // erased once its queue entry is reached
 }
 
 void SpawnManager::RemoveSpawns(std::vector<uint32> const& creatureDbGuids, std::vector<uint32> const& goDbGuids)
 {
-    for (auto& spawnInfo : m_spawns)
-    {
-        switch (spawnInfo.GetHighGuid())
-        {
-            case HIGHGUID_GAMEOBJECT:
-                if (std::find(goDbGuids.begin(), goDbGuids.end(), spawnInfo.GetDbGuid()) != goDbGuids.end())
-                    spawnInfo.SetUsed(); // will be erased on next manager update
-                break;
-            case HIGHGUID_UNIT:
-                if (std::find(creatureDbGuids.begin(), creatureDbGuids.end(), spawnInfo.GetDbGuid()) != creatureDbGuids.end())
-                    spawnInfo.SetUsed(); // will be erased on next manager update
-                break;
-            default: break;
-        }
-    }
+    auto guard = m_map.GetParallelUpdateGuard();
+    for (uint32 dbguid : creatureDbGuids)
+        RemoveSpawn(dbguid, HIGHGUID_UNIT);
+    for (uint32 dbguid : goDbGuids)
+        RemoveSpawn(dbguid, HIGHGUID_GAMEOBJECT);
 }
 
 void SpawnManager::RemoveSpawn(uint32 dbguid, HighGuid high)
 {
-    for (auto& spawnInfo : m_spawns)
-    {
-        if (spawnInfo.GetHighGuid() == high && spawnInfo.GetDbGuid() == dbguid)
-        {
-            spawnInfo.SetUsed(); // will be erased on next manager update
-            break;
-        }
-    }
+    auto guard = m_map.GetParallelUpdateGuard();
+    auto itr = m_spawns.find(GetSpawnKey(dbguid, high));
+    if (itr == m_spawns.end())
+        return;
+
+    // its queue entry becomes outdated and is skipped
+    if (m_updated)
+        itr->second.SetUsed(); // will be erased once its queue entry is reached
+    else
+        m_spawns.erase(itr);
 }
 
 void SpawnManager::AddEventGuid(uint32 dbguid, HighGuid high)
@@ -239,35 +243,60 @@ bool SpawnManager::IsEventGuid(uint32 dbguid, HighGuid high) const
 
 void SpawnManager::RespawnAll()
 {
-    for (auto itr = m_spawns.begin(); itr != m_spawns.end();)
+    m_updated = true;
+    for (auto& data : m_spawns)
     {
-        auto& spawnInfo = *itr;
+        auto& spawnInfo = data.second;
+        if (spawnInfo.IsUsed())
+            continue;
         if (spawnInfo.GetHighGuid() == HIGHGUID_GAMEOBJECT)
             m_map.GetPersistentState()->SaveGORespawnTime(spawnInfo.GetDbGuid(), 0);
         if (spawnInfo.GetHighGuid() == HIGHGUID_UNIT)
             m_map.GetPersistentState()->SaveCreatureRespawnTime(spawnInfo.GetDbGuid(), 0);
         spawnInfo.ConstructForMap(m_map);
     }
+    m_updated = false;
+
+    for (auto itr = m_spawns.begin(); itr != m_spawns.end();)
+    {
+        if (itr->second.IsUsed())
+            itr = m_spawns.erase(itr);
+        else
+            ++itr;
+    }
+    AddDeferredSpawns();
 }
 
 void SpawnManager::Update()
 {
+    AddDeferredSpawns();
+
+    // only due respawns are visited, cost does not depend on the amount of pending spawns
     m_updated = true;
-    if (!m_deferredSpawns.empty()) // cannot insert during update
-    {
-        m_spawns.reserve(m_spawns.size() + m_spawns.size());
-        std::move(std::begin(m_deferredSpawns), std::end(m_deferredSpawns), std::back_inserter(m_deferredSpawns));
-        m_deferredSpawns.clear();
-    }
     auto now = m_map.GetCurrentClockTime();
-    for (auto itr = m_spawns.begin(); itr != m_spawns.end();)
+    std::vector<uint64> failedSpawns;
+    while (!m_spawnQueue.empty() && m_spawnQueue.top().respawnTime <= now)
     {
-        auto& spawnInfo = *itr;
-        if (spawnInfo.IsUsed() ||
-            (spawnInfo.GetRespawnTime() <= now && spawnInfo.ConstructForMap(m_map)))
-            itr = m_spawns.erase(itr);
+        SpawnQueueEntry queueEntry = m_spawnQueue.top();
+        m_spawnQueue.pop();
+
+        auto itr = m_spawns.find(queueEntry.key);
+        if (itr == m_spawns.end() || itr->second.GetScheduleId() != queueEntry.scheduleId)
+            continue;
+
+        auto& spawnInfo = itr->second;
+        if (spawnInfo.IsUsed() || spawnInfo.ConstructForMap(m_map))
+            m_spawns.erase(itr);
         else
-            ++itr;
+            failedSpawns.push_back(queueEntry.key);
+    }
+
+    // retried next update, like linked spawns waiting for their master
+    for (uint64 key : failedSpawns)
+    {
+        auto itr = m_spawns.find(key);
+        if (itr != m_spawns.end())
+            ScheduleSpawn(itr->second);
     }
     m_updated = false;
 
@@ -279,8 +308,11 @@ void SpawnManager::Update()
 std::string SpawnManager::GetRespawnList()
 {
     std::string output = "";
-    for (auto& data : m_spawns)
+    for (auto& spawnData : m_spawns)
     {
+        SpawnInfo const& data = spawnData.second;
+        if (data.IsUsed())
+            continue;
         output += "DBGuid: " + std::to_string(data.GetDbGuid()) + "HighGuid: " + (data.GetHighGuid() == HIGHGUID_UNIT ? "Creature" : "GameObject") + "Respawn Time ";
         auto diff = (data.GetRespawnTime() - m_map.GetCurrentClockTime()).count();
         if (auto hours = diff / (HOUR * IN_MILLISECONDS))
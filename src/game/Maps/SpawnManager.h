@@ -24,13 +24,14 @@
 #include "Maps/SpawnGroup.h"
 
 #include <string>
+#include <queue>
 
 class Map;
 
 class SpawnInfo
 {
     public:
-        SpawnInfo(TimePoint when, uint32 dbguid, HighGuid high) : m_respawnTime(when), m_dbguid(dbguid), m_high(high), m_used(false), m_inUse(false){}
+        SpawnInfo(TimePoint when, uint32 dbguid, HighGuid high) : m_respawnTime(when), m_dbguid(dbguid), m_high(high), m_used(false), m_inUse(false), m_scheduleId(0) {}
         TimePoint const& GetRespawnTime() const { return m_respawnTime; }
         void SetRespawnTime(TimePoint const& time) { m_respawnTime = time; }
         bool ConstructForMap(Map& map); // can fail due to linking, pooling not supported
@@ -38,12 +39,26 @@ class SpawnInfo
         HighGuid GetHighGuid() const { return m_high; }
         void SetUsed() { m_used = true; }
         bool IsUsed() const { return m_inUse || m_used; }
+        uint64 GetScheduleId() const { return m_scheduleId; }
+        void SetScheduleId(uint64 scheduleId) { m_scheduleId = scheduleId; }
     private:
         TimePoint m_respawnTime;
         uint32 m_dbguid;
         HighGuid m_high;
         bool m_used;
         bool m_inUse;
+        uint64 m_scheduleId;                                // matches the latest SpawnQueueEntry of this spawn
+};
+
+// respawn queue entry, outdated once the spawn is removed or scheduled again
+struct SpawnQueueEntry
+{
+    SpawnQueueEntry(TimePoint when, uint64 spawnKey, uint64 id) : respawnTime(when), key(spawnKey), scheduleId(id) {}
+    bool operator>(SpawnQueueEntry const& other) const { return respawnTime > other.respawnTime; }
+
+    TimePoint respawnTime;
+    uint64 key;
+    uint64 scheduleId;
 };
 
 bool operator<(SpawnInfo const& lhs, SpawnInfo const& rhs);
@@ -51,7 +66,7 @@ bool operator<(SpawnInfo const& lhs, SpawnInfo const& rhs);
 class SpawnManager
 {
     public:
-        SpawnManager(Map& map) : m_map(map), m_updated(false) {}
+        SpawnManager(Map& map) : m_map(map), m_updated(false), m_nextScheduleId(0) {}
         ~SpawnManager();
         void Initialize();
 
@@ -79,12 +94,20 @@ class SpawnManager
 
         void RespawnSpawnGroupsInVicinity(Position pos, float range);
     private:
+        static uint64 GetSpawnKey(uint32 dbguid, HighGuid high) { return uint64(high) << 32 | dbguid; }
+        SpawnInfo* FindSpawn(uint32 dbguid, HighGuid high);
+        void AddSpawn(SpawnInfo&& spawnInfo);
+        void ScheduleSpawn(SpawnInfo& spawnInfo);
+        void AddDeferredSpawns();
+
         Map& m_map;
 
         std::vector<SpawnInfo> m_deferredSpawns;
-        std::vector<SpawnInfo> m_spawns; // must only be erased from in Update
+        std::unordered_map<uint64, SpawnInfo> m_spawns; // must only be erased from outside of Update/RespawnAll
+        std::priority_queue<SpawnQueueEntry, std::vector<SpawnQueueEntry>, std::greater<SpawnQueueEntry>> m_spawnQueue;
         std::map<uint32, SpawnGroup*> m_spawnGroups;
         bool m_updated;
+        uint64 m_nextScheduleId;
 
         std::set<uint32> m_eventCreatureDbGuids;
         std::set<uint32> m_eventGoDbGuids;
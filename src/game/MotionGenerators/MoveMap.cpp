@@ -21,6 +21,7 @@
 #include "Entities/Creature.h"
 #include "MotionGenerators/MoveMap.h"
 #include "MoveMapSharedDefines.h"
+#include "Platform/Filesystem.h"
 
 namespace MMAP
 {
@@ -31,6 +32,9 @@ namespace MMAP
     // stores list of mapids which do not use pathfinding
     std::set<uint32>* g_mmapDisabledIds = nullptr;
 
+    // bumped before any navmesh query is freed, drops the per thread query caches of GetNavMeshQuery
+    std::atomic<uint32> g_navMeshQueryEpoch(0);
+
     MMapManager* MMapFactory::createOrGetMMapManager()
     {
         if (g_MMapManager == nullptr)
@@ -120,20 +124,95 @@ namespace MMAP
     {
         // by now we should not have maps loaded
         // if we had, tiles in MMapData->mmapLoadedTiles, their actual data is lost!
+        ++g_navMeshQueryEpoch;
     }
 
     void MMapManager::ChangeTile(uint32 mapId, uint32 instanceId, uint32 tileX, uint32 tileY, uint32 tileNumber)
     {
+        if (!loadMapData(mapId, instanceId))
+            return;
+
+        // tile files are read before taking the lock, map threads keep using their navmesh meanwhile
+        std::vector<uint32> sharedTiles;
+        {
+            std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+            auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
+            if (itr != m_loadedMMaps.end() && itr->second->shared)
+                for (auto const& loadedTile : itr->second->shared->mmapLoadedTiles)
+                    sharedTiles.push_back(loadedTile.first);
+        }
+
+        MMapTileSet detachedTiles;
+        dtNavMesh* detachedMesh = sharedTiles.empty() ? nullptr : buildNavMesh(mapId, sharedTiles, detachedTiles);
+
+        MMapTileData tile;
+        readTile(mapId, tileX, tileY, tileNumber, tile);
+
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
+        // other instances keep using the unchanged shared navmesh
+        if (detachedMesh)
+            detachMapInstance(mapId, instanceId, detachedMesh, detachedTiles);
+
         unloadMap(mapId, instanceId, tileX, tileY);
-        loadMap(mapId, instanceId, tileX, tileY, tileNumber);
+        loadMap(mapId, instanceId, tileX, tileY, tile);
     }
 
     bool MMapManager::loadMapData(uint32 mapId, uint32 instanceId)
     {
-        // we already have this map loaded?
-        if (m_loadedMMaps.find(packInstanceId(mapId, instanceId)) != m_loadedMMaps.end())
+        uint64 packedInstanceId = packInstanceId(mapId, instanceId);
+        {
+            std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
+            // we already have this map loaded?
+            if (m_loadedMMaps.find(packedInstanceId) != m_loadedMMaps.end())
+                return true;
+
+            // instances of the same map use one navmesh holding all its tiles
+            MMapTileSet noTiles;
+            if (instanceId)
+            {
+                if (SharedMMapData* shared = acquireSharedMesh(mapId, nullptr, noTiles))
+                {
+                    auto mmapData = std::make_unique<MMapData>(shared->navMesh, shared);
+                    mmapData->mmapLoadedTiles = shared->mmapLoadedTiles;
+                    m_loadedMMaps.emplace(packedInstanceId, std::move(mmapData));
+                    return true;
+                }
+            }
+        }
+
+        // files are read without holding the lock, other maps keep pathfinding meanwhile
+        MMapTileSet loadedTiles;
+        dtNavMesh* mesh = instanceId ? buildNavMesh(mapId, getTileList(mapId), loadedTiles) : createNavMesh(mapId);
+        if (!mesh)
+            return false;
+
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
+        // loaded by another thread meanwhile
+        if (m_loadedMMaps.find(packedInstanceId) != m_loadedMMaps.end())
+        {
+            discardNavMesh(mesh, loadedTiles);
             return true;
+        }
+
+        if (instanceId)
+        {
+            SharedMMapData* shared = acquireSharedMesh(mapId, mesh, loadedTiles);
+            auto mmapData = std::make_unique<MMapData>(shared->navMesh, shared);
+            mmapData->mmapLoadedTiles = shared->mmapLoadedTiles;
+            m_loadedMMaps.emplace(packedInstanceId, std::move(mmapData));
+            return true;
+        }
 
+        // store inside our map list
+        m_loadedMMaps.emplace(packedInstanceId, std::make_unique<MMapData>(mesh));
+        return true;
+    }
+
+    dtNavMesh* MMapManager::createNavMesh(uint32 mapId) const
+    {
         // load and init dtNavMesh - read parameters from file
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i.mmap") + 1;
         char* fileName = new char[pathLen];
@@ -145,7 +224,7 @@ namespace MMAP
             if (MMapFactory::IsPathfindingEnabled(mapId))
                 sLog.outError("MMAP:loadMapData: Error: Could not open mmap file '%s'", fileName);
             delete[] fileName;
-            return false;
+            return nullptr;
         }
 
         dtNavMeshParams params;
@@ -160,18 +239,131 @@ namespace MMAP
             dtFreeNavMesh(mesh);
             sLog.outError("MMAP:loadMapData: Failed to initialize dtNavMesh for mmap %03u from file %s", mapId, fileName);
             delete[] fileName;
-            return false;
+            return nullptr;
         }
 
         delete[] fileName;
 
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMapData: Loaded %03i.mmap", mapId);
+        return mesh;
+    }
 
-        // store inside our map list
-        m_loadedMMaps.emplace(packInstanceId(mapId, instanceId), std::make_unique<MMapData>(mesh));
+    dtNavMesh* MMapManager::buildNavMesh(uint32 mapId, std::vector<uint32> const& tiles, MMapTileSet& loadedTiles)
+    {
+        dtNavMesh* mesh = createNavMesh(mapId);
+        if (!mesh)
+            return nullptr;
+
+        for (uint32 packedGridPos : tiles)
+        {
+            int32 x = int32(packedGridPos >> 16);
+            int32 y = int32(packedGridPos & 0x0000FFFF);
+
+            MMapTileData tile;
+            if (readTile(mapId, x, y, 0, tile))
+                addTile(mesh, loadedTiles, mapId, x, y, tile);
+        }
+
+        return mesh;
+    }
+
+    void MMapManager::discardNavMesh(dtNavMesh* mesh, MMapTileSet const& loadedTiles)
+    {
+        m_loadedTiles -= loadedTiles.size();
+        dtFreeNavMesh(mesh);
+    }
+
+    SharedMMapData* MMapManager::acquireSharedMesh(uint32 mapId, dtNavMesh* mesh, MMapTileSet& loadedTiles)
+    {
+        auto itr = m_sharedMMaps.find(mapId);
+        if (itr == m_sharedMMaps.end())
+        {
+            if (!mesh)
+                return nullptr;
+
+            // all tiles are added by now, afterwards the navmesh is never modified and can be queried from any map thread
+            auto shared = std::make_unique<SharedMMapData>(mesh);
+            shared->mmapLoadedTiles = std::move(loadedTiles);
+
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:acquireSharedMesh: Loaded shared navmesh of map %03u with %u tiles", mapId, uint32(shared->mmapLoadedTiles.size()));
+            itr = m_sharedMMaps.emplace(mapId, std::move(shared)).first;
+        }
+        else if (mesh)
+            discardNavMesh(mesh, loadedTiles);
+
+        ++itr->second->instances;
+        return itr->second.get();
+    }
+
+    void MMapManager::releaseSharedMesh(uint32 mapId)
+    {
+        auto itr = m_sharedMMaps.find(mapId);
+        if (itr == m_sharedMMaps.end())
+            return;
+
+        if (--itr->second->instances)
+            return;
+
+        m_loadedTiles -= itr->second->mmapLoadedTiles.size();
+        m_sharedMMaps.erase(itr);
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:releaseSharedMesh: Unloaded shared navmesh of map %03u", mapId);
+    }
+
+    bool MMapManager::detachMapInstance(uint32 mapId, uint32 instanceId, dtNavMesh* mesh, MMapTileSet& loadedTiles)
+    {
+        // instance was unloaded or already detached while the navmesh was built
+        auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
+        if (itr == m_loadedMMaps.end() || !itr->second->shared)
+        {
+            discardNavMesh(mesh, loadedTiles);
+            return false;
+        }
+
+        const auto& mmapData = itr->second;
+
+        // queries are cached by path finders, keep them and only point them to the new navmesh
+        for (auto& navMeshQuery : mmapData->navMeshQueries)
+            navMeshQuery.second->init(mesh, 1024);
+
+        mmapData->navMesh = mesh;
+        mmapData->mmapLoadedTiles = std::move(loadedTiles);
+        mmapData->shared = nullptr;
+        releaseSharedMesh(mapId);
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:detachMapInstance: mapId %03u instanceId %u now uses its own navmesh", mapId, instanceId);
         return true;
     }
 
+    std::vector<uint32> MMapManager::getTileList(uint32 mapId)
+    {
+        std::lock_guard<std::mutex> guard(m_tileIndexMutex);
+
+        // scan the directory once instead of probing every possible tile file of every map
+        if (!m_tileIndexBuilt)
+        {
+            m_tileIndexBuilt = true;
+
+            MaNGOS::Filesystem::path mmapPath(sWorld.GetDataPath() + "mmaps");
+            boost::system::error_code ec;
+            for (MaNGOS::Filesystem::directory_iterator itr(mmapPath, ec), end; !ec && itr != end; itr.increment(ec))
+            {
+                // base tiles only, named %03u%02i%02i.mmtile
+                std::string fileName = itr->path().filename().string();
+                if (fileName.length() != 14 || fileName.compare(7, 7, ".mmtile") != 0 ||
+                        fileName.find_first_not_of("0123456789") != 7)
+                    continue;
+
+                uint32 tileMapId = uint32(std::stoul(fileName.substr(0, 3)));
+                int32 x = std::stoi(fileName.substr(3, 2));
+                int32 y = std::stoi(fileName.substr(5, 2));
+                m_tileIndex[tileMapId].push_back(packTileID(x, y));
+            }
+        }
+
+        auto itr = m_tileIndex.find(mapId);
+        return itr != m_tileIndex.end() ? itr->second : std::vector<uint32>();
+    }
+
     uint32 MMapManager::packTileID(int32 x, int32 y) const
     {
         return uint32(x << 16 | y);
@@ -184,6 +376,8 @@ namespace MMAP
 
     bool MMapManager::IsMMapTileLoaded(uint32 mapId, uint32 instanceId, uint32 x, uint32 y) const
     {
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
         // get this mmap data
         auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
 
@@ -205,24 +399,37 @@ namespace MMAP
         if (!loadMapData(mapId, instanceId))
             return false;
 
-        // get this mmap data
-        const auto& mmapData = m_loadedMMaps[packInstanceId(mapId, instanceId)];
-        MANGOS_ASSERT(mmapData->navMesh);
+        {
+            std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
+            // check if we already have this tile loaded
+            if (IsMMapTileLoaded(mapId, instanceId, x, y))
+            {
+                sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. ");
+                return false;
+            }
+
+            // shared navmesh already holds every tile of the map
+            if (m_loadedMMaps[packInstanceId(mapId, instanceId)]->shared)
+                return false;
+        }
+
+        // tile is read without the lock and added by loadMap below, which checks again
+        MMapTileData tile;
+        if (!readTile(mapId, x, y, number, tile))
+            return false;
 
+        return loadMap(mapId, instanceId, x, y, tile);
+    }
+
+    bool MMapManager::readTile(uint32 mapId, int32 x, int32 y, uint32 number, MMapTileData& tile)
+    {
         char fileName[100];
         if (number == 0)
             sprintf(fileName, "%03u%02i%02i.mmtile", mapId, x, y);
         else
             sprintf(fileName, "%03u%02i%02i_%02i.mmtile", mapId, x, y, number);
 
-        // check if we already have this tile loaded
-        uint32 packedGridPos = packTileID(x, y);
-        if (mmapData->mmapLoadedTiles.find(packedGridPos) != mmapData->mmapLoadedTiles.end())
-        {
-            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. ");
-            return false;
-        }
-
         std::string filePath = sWorld.GetDataPath() + std::string("mmaps/") + fileName;
         // load this tile
         FILE* file = fopen(filePath.c_str(), "rb");
@@ -258,27 +465,67 @@ namespace MMAP
         if (!result)
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %s", fileName);
+            dtFree(data);
             fclose(file);
             return false;
         }
 
         fclose(file);
 
-        dtMeshHeader* header = (dtMeshHeader*)data;
+        tile.data = data;
+        tile.size = fileHeader.size;
+        return true;
+    }
+
+    bool MMapManager::loadMap(uint32 mapId, uint32 instanceId, int32 x, int32 y, MMapTileData& tile)
+    {
+        if (!tile.data)
+            return false;
+
+        // make sure the mmap is loaded and ready to load tiles
+        if (!loadMapData(mapId, instanceId))
+            return false;
+
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
+        // get this mmap data
+        const auto& mmapData = m_loadedMMaps[packInstanceId(mapId, instanceId)];
+        MANGOS_ASSERT(mmapData->navMesh);
+
+        // check if we already have this tile loaded
+        uint32 packedGridPos = packTileID(x, y);
+        if (mmapData->mmapLoadedTiles.find(packedGridPos) != mmapData->mmapLoadedTiles.end())
+        {
+            // all tiles of a shared navmesh are loaded with it
+            if (!mmapData->shared)
+                sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. ");
+            return false;
+        }
+
+        // shared navmesh is never modified, tiles missing from it do not exist on disk
+        if (mmapData->shared)
+            return false;
+
+        return addTile(mmapData->navMesh, mmapData->mmapLoadedTiles, mapId, x, y, tile);
+    }
+
+    bool MMapManager::addTile(dtNavMesh* navMesh, MMapTileSet& loadedTiles, uint32 mapId, int32 x, int32 y, MMapTileData& tile)
+    {
+        dtMeshHeader* header = (dtMeshHeader*)tile.data;
         dtTileRef tileRef = 0;
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmapData->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        dtStatus dtResult = navMesh->addTile(tile.data, tile.size, DT_TILE_FREE_DATA, 0, &tileRef);
         if (dtStatusFailed(dtResult))
         {
-            sLog.outError("MMAP:loadMap: Could not load %s into navmesh", fileName);
-            dtFree(data);
+            sLog.outError("MMAP:loadMap: Could not load tile %03u[%02i,%02i] into navmesh", mapId, x, y);
             return false;
         }
+        tile.data = nullptr;
 
-        mmapData->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        loadedTiles.insert(std::pair<uint32, dtTileRef>(packTileID(x, y), tileRef));
         ++m_loadedTiles;
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap:%s: Loaded into %03i[%02i,%02i]", fileName, mapId, header->x, header->y);
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded into %03i[%02i,%02i]", mapId, header->x, header->y);
         return true;
     }
 
@@ -356,6 +603,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId, uint32 instanceId, int32 x, int32 y)
     {
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
         // check if we have this map loaded
         auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
         if (itr == m_loadedMMaps.end())
@@ -367,6 +616,10 @@ namespace MMAP
 
         const auto& mmapData = (*itr).second;
 
+        // tiles stay in the shared navmesh until its last instance is unloaded
+        if (mmapData->shared)
+            return false;
+
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
         if (mmapData->mmapLoadedTiles.find(packedGridPos) == mmapData->mmapLoadedTiles.end())
@@ -401,6 +654,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
         bool success = false;
         // unload all maps with given mapId
         for (auto itr = m_loadedMMaps.begin(); itr != m_loadedMMaps.end();)
@@ -427,6 +682,7 @@ namespace MMAP
                 }
             }
 
+            ++g_navMeshQueryEpoch;
             itr = m_loadedMMaps.erase(itr);
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded %03i.mmap", mapId);
             success = true;
@@ -441,6 +697,8 @@ namespace MMAP
 
     bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
     {
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
         // check if we have this map loaded
         auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
         if (itr == m_loadedMMaps.end())
@@ -450,17 +708,34 @@ namespace MMAP
             return false;
         }
 
+        // continents keep their navmesh until the terrain is unloaded, see unloadMap(uint32)
         const auto& mmapData = (*itr).second;
-        if (mmapData->navMeshQueries.find(instanceId) == mmapData->navMeshQueries.end())
+        if (!instanceId)
         {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
+            if (mmapData->navMeshQueries.empty())
+            {
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
+                return false;
+            }
+
+            ++g_navMeshQueryEpoch;
+            for (auto& navMeshQuery : mmapData->navMeshQueries)
+                dtFreeNavMeshQuery(navMeshQuery.second);
+            mmapData->navMeshQueries.clear();
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
+            return true;
         }
 
-        dtNavMeshQuery* query = mmapData->navMeshQueries[instanceId];
+        // navmesh of an instance is not used by anything else
+        bool shared = mmapData->shared != nullptr;
+        if (!shared)
+            m_loadedTiles -= mmapData->mmapLoadedTiles.size();
+
+        ++g_navMeshQueryEpoch;
+        m_loadedMMaps.erase(itr);
+        if (shared)
+            releaseSharedMesh(mapId);
 
-        dtFreeNavMeshQuery(query);
-        mmapData->navMeshQueries.erase(instanceId);
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
         return true;
@@ -468,6 +743,8 @@ namespace MMAP
 
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId, uint32 instanceId)
     {
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
         auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
         if (itr == m_loadedMMaps.end())
             return nullptr;
@@ -485,12 +762,32 @@ namespace MMAP
 
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
-        auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
+        // every thread remembers its queries, m_mapsMutex is only taken to look up a new one
+        thread_local std::unordered_map<uint64, dtNavMeshQuery*> cachedQueries;
+        thread_local uint32 cachedQueriesEpoch = 0;
+
+        uint32 epoch = g_navMeshQueryEpoch.load();
+        if (cachedQueriesEpoch != epoch)
+        {
+            cachedQueries.clear();
+            cachedQueriesEpoch = epoch;
+        }
+
+        uint64 packedInstanceId = packInstanceId(mapId, instanceId);
+        auto cachedItr = cachedQueries.find(packedInstanceId);
+        if (cachedItr != cachedQueries.end())
+            return cachedItr->second;
+
+        std::lock_guard<std::recursive_mutex> guard(m_mapsMutex);
+
+        auto itr = m_loadedMMaps.find(packedInstanceId);
         if (itr == m_loadedMMaps.end())
             return nullptr;
 
+        auto threadId = std::this_thread::get_id();
         const auto& mmapData = (*itr).second;
-        if (mmapData->navMeshQueries.find(instanceId) == mmapData->navMeshQueries.end())
+        auto queryItr = mmapData->navMeshQueries.find(threadId);
+        if (queryItr == mmapData->navMeshQueries.end())
         {
             // allocate mesh query
             dtNavMeshQuery* query = dtAllocNavMeshQuery();
@@ -504,10 +801,11 @@ namespace MMAP
             }
 
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmapData->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+            queryItr = mmapData->navMeshQueries.emplace(threadId, query).first;
         }
 
-        return mmapData->navMeshQueries[instanceId];
+        cachedQueries.emplace(packedInstanceId, queryItr->second);
+        return queryItr->second;
     }
 
     dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
@@ -24,6 +24,7 @@
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -44,29 +45,59 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshQuerySet;
     typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshGOQuerySet;
 
+    // navmesh of an instanceable map, all tiles are added once and then only read by the instances using it
+    struct SharedMMapData
+    {
+        SharedMMapData(dtNavMesh* mesh) : navMesh(mesh), instances(0) {}
+        ~SharedMMapData()
+        {
+            if (navMesh)
+                dtFreeNavMesh(navMesh);
+        }
+
+        dtNavMesh* navMesh;
+        MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        uint32 instances;                   // instances currently using navMesh
+    };
+
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh, SharedMMapData* sharedData = nullptr) : navMesh(mesh), shared(sharedData) {}
         ~MMapData()
         {
             for (auto& navMeshQuerie : navMeshQueries)
                 dtFreeNavMeshQuery(navMeshQuerie.second);
 
-            if (navMesh)
+            // shared navmesh is freed by its SharedMMapData
+            if (navMesh && !shared)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
+        SharedMMapData* shared;             // set while navMesh is the shared navmesh of the map
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // dtNavMeshQuery is not thread safe, and objects of one map may be updated by several threads
+        NavMeshQuerySet navMeshQueries;     // thread to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
     };
 
+    // navmesh tile read from disk, owned by the navmesh once added to it
+    struct MMapTileData
+    {
+        MMapTileData() : data(nullptr), size(0) {}
+        ~MMapTileData() { if (data) dtFree(data); }
+
+        MMapTileData(const MMapTileData&) = delete;
+        MMapTileData& operator=(const MMapTileData&) = delete;
+
+        unsigned char* data;
+        uint32 size;
+    };
+
     struct MMapGOData
     {
         MMapGOData(dtNavMesh* mesh) : navMesh(mesh) {}
@@ -91,10 +122,14 @@ namespace MMAP
     class MMapManager
     {
         public:
-            MMapManager() : m_loadedTiles(0) {}
+            MMapManager() : m_loadedTiles(0), m_tileIndexBuilt(false) {}
             ~MMapManager();
 
             bool loadMap(uint32 mapId, uint32 instanceId, int32 x, int32 y, uint32 number);
+            // add a tile read in advance by readTile, tile data is taken over on success
+            bool loadMap(uint32 mapId, uint32 instanceId, int32 x, int32 y, MMapTileData& tile);
+            // only reads the tile file, safe to call from any thread
+            static bool readTile(uint32 mapId, int32 x, int32 y, uint32 number, MMapTileData& tile);
             bool loadMapData(uint32 mapId, uint32 instanceId);
             void loadAllGameObjectModels(std::vector<uint32> const& displayIds);
             bool loadGameObject(uint32 displayId);
@@ -103,7 +138,7 @@ namespace MMAP
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
             bool IsMMapTileLoaded(uint32 mapId, uint32 instanceId, uint32 x, uint32 y) const;
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
+            // the returned [dtNavMeshQuery const*] belongs to the calling thread and must not be used by another one
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId, uint32 instanceId);
@@ -117,8 +152,26 @@ namespace MMAP
             uint32 packTileID(int32 x, int32 y) const;
             uint64 packInstanceId(uint32 mapId, uint32 instanceId) const;
 
+            dtNavMesh* createNavMesh(uint32 mapId) const;
+            bool addTile(dtNavMesh* navMesh, MMapTileSet& loadedTiles, uint32 mapId, int32 x, int32 y, MMapTileData& tile);
+            // reads the given base tiles into a new navmesh, done without holding m_mapsMutex
+            dtNavMesh* buildNavMesh(uint32 mapId, std::vector<uint32> const& tiles, MMapTileSet& loadedTiles);
+            void discardNavMesh(dtNavMesh* mesh, MMapTileSet const& loadedTiles);
+            // mesh built by buildNavMesh is published as the shared navmesh, or freed if another thread was faster
+            SharedMMapData* acquireSharedMesh(uint32 mapId, dtNavMesh* mesh, MMapTileSet& loadedTiles);
+            void releaseSharedMesh(uint32 mapId);
+            // gives the instance the navmesh built by buildNavMesh so its tiles can be changed without affecting other instances
+            bool detachMapInstance(uint32 mapId, uint32 instanceId, dtNavMesh* mesh, MMapTileSet& loadedTiles);
+            std::vector<uint32> getTileList(uint32 mapId);
+
             std::unordered_map<uint64, std::unique_ptr<MMapData>> m_loadedMMaps;
-            uint32 m_loadedTiles;
+            std::unordered_map<uint32, std::unique_ptr<SharedMMapData>> m_sharedMMaps;
+            std::atomic<uint32> m_loadedTiles;
+            mutable std::recursive_mutex m_mapsMutex;
+
+            std::unordered_map<uint32, std::vector<uint32>> m_tileIndex;    // mapId to packed grid coords of its base tiles on disk
+            bool m_tileIndexBuilt;
+            std::mutex m_tileIndexMutex;
 
             std::unordered_map<uint32, std::unique_ptr<MMapGOData>> m_loadedModels;
             std::mutex m_modelsMutex;
@@ -36,7 +36,7 @@ PathFinder::PathFinder(const Unit* owner, bool ignoreNormalization) :
     m_type(PATHFIND_BLANK), m_useStraightPath(false), m_forceDestination(false), m_straightLine(false),
     m_pointPathLimit(MAX_POINT_PATH_LENGTH), // TODO: Fix legitimate long paths
     m_cachedPoints(m_pointPathLimit * VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_polyLength(0),
-    m_smoothPathPolyRefs(m_pointPathLimit), m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr),
+    m_smoothPathPolyRefs(m_pointPathLimit), m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_defaultNavMeshQuery(nullptr),
     m_defaultMapId(m_sourceUnit->GetMapId()), m_ignoreNormalization(ignoreNormalization)
 {
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
@@ -45,6 +45,7 @@ PathFinder::PathFinder(const Unit* owner, bool ignoreNormalization) :
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+        m_defaultQueryThread = std::this_thread::get_id();
     }
 
     createFilter();
@@ -64,8 +65,13 @@ void PathFinder::SetCurrentNavMesh()
             m_navMeshQuery = mmap->GetModelNavMeshQuery(transport->GetDisplayId());
         else
         {
-            if (m_defaultMapId != m_sourceUnit->GetMapId())
+            // queries are per thread, the owner may be updated by another thread than the previous time
+            if (m_defaultMapId != m_sourceUnit->GetMapId() || m_defaultQueryThread != std::this_thread::get_id())
+            {
                 m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+                m_defaultMapId = m_sourceUnit->GetMapId();
+                m_defaultQueryThread = std::this_thread::get_id();
+            }
 
             m_navMeshQuery = m_defaultNavMeshQuery;
         }
@@ -26,6 +26,8 @@
 
 #include "Movement/MoveSplineInitArgs.h"
 
+#include <thread>
+
 using Movement::Vector3;
 using Movement::PointsArray;
 
@@ -115,6 +117,7 @@ class PathFinder
 
         const dtNavMeshQuery*   m_defaultNavMeshQuery;     // the nav mesh query used to find the path
         uint32                  m_defaultMapId;
+        std::thread::id         m_defaultQueryThread;       // thread m_defaultNavMeshQuery belongs to
 
         bool                    m_ignoreNormalization;
 
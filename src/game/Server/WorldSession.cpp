@@ -101,7 +101,7 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetStorageLocaleIndexFor(locale)),
     m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_sessionState(WORLD_SESSION_STATE_CREATED),
     m_timeSyncClockDeltaQueue(6), m_timeSyncClockDelta(0), m_pendingTimeSyncRequests(), m_timeSyncNextCounter(0), m_timeSyncTimer(0),
-    m_requestSocket(nullptr), m_recruitingFriendId(recruitingFriend), m_isRecruiter(isARecruiter) {}
+    m_requestSocket(nullptr), m_recruitingFriendId(recruitingFriend), m_isRecruiter(isARecruiter), m_packetsAllocated(0), m_packetsReused(0) {}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -200,6 +200,19 @@ void WorldSession::SetExpansion(uint8 expansion)
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const& packet) const
+{
+    if (PrepareSendPacket(packet))
+        m_Socket->SendPacket(packet);
+}
+
+void WorldSession::SendPacket(std::shared_ptr<WorldPacket const> const& packet) const
+{
+    if (PrepareSendPacket(*packet))
+        m_Socket->SendPacket(packet);
+}
+
+/// Common part of both SendPacket, returns false when there is no socket to send to
+bool WorldSession::PrepareSendPacket(WorldPacket const& packet) const
 {
 #ifdef BUILD_DEPRECATED_PLAYERBOT
     // Send packet to bot AI
@@ -213,7 +226,7 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 #endif
 
     if (!m_Socket || m_Socket->IsClosed())
-        return;
+        return false;
 
 #ifdef MANGOS_DEBUG
 
@@ -251,7 +264,7 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 
 #endif                                                  // !MANGOS_DEBUG
 
-    m_Socket->SendPacket(packet);
+    return true;
 }
 
 /// Add an incoming packet to the queue
@@ -272,6 +285,8 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 
         if (new_packet->rpos() < new_packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
             LogUnprocessedTail(*new_packet);
+
+        RecyclePacket(std::move(new_packet));
         return;
     }
 
@@ -287,6 +302,43 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
     }
 }
 
+std::unique_ptr<WorldPacket> WorldSession::AcquirePacket(uint16 opcode, size_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_packetPoolLock);
+        if (!m_packetPool.empty())
+        {
+            std::unique_ptr<WorldPacket> packet = std::move(m_packetPool.back());
+            m_packetPool.pop_back();
+            ++m_packetsReused;
+
+            // clearing keeps the storage, small client packets fit without a new allocation
+            packet->Initialize(Opcodes(opcode), size);
+            return packet;
+        }
+    }
+
+    ++m_packetsAllocated;
+    return std::unique_ptr<WorldPacket>(new WorldPacket(Opcodes(opcode), size));
+}
+
+void WorldSession::RecyclePacket(std::unique_ptr<WorldPacket> packet)
+{
+    // rare big packets are not worth holding on to
+    if (packet->size() > 1024)
+        return;
+
+    std::lock_guard<std::mutex> guard(m_packetPoolLock);
+    if (m_packetPool.size() < 64)
+        m_packetPool.push_back(std::move(packet));
+}
+
+void WorldSession::ResetPacketPoolCounters(uint32& allocated, uint32& reused)
+{
+    allocated = m_packetsAllocated.exchange(0);
+    reused = m_packetsReused.exchange(0);
+}
+
 void WorldSession::DeleteMovementPackets()
 {
     std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
@@ -297,6 +349,7 @@ void WorldSession::DeleteMovementPackets()
             case MSG_MOVE_SET_FACING:
             case MSG_MOVE_HEARTBEAT:
             {
+                RecyclePacket(std::move(*itr));
                 itr = m_recvQueueMap.erase(itr);
                 break;
             }
@@ -351,12 +404,14 @@ void WorldSession::ProcessByteBufferException(WorldPacket const& packet)
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(uint32 /*diff*/)
 {
+    // async DB requests of the account keep their order, other accounts may be served by other DB workers
+    SqlOrderingKey orderingKey(GetAccountId());
+
     GetMessager().Execute(this);
 
-    std::deque<std::unique_ptr<WorldPacket>> recvQueueCopy;
     {
         std::lock_guard<std::mutex> guard(m_recvQueueLock);
-        std::swap(recvQueueCopy, m_recvQueue);
+        std::swap(m_recvQueueProcessing, m_recvQueue);
     }
 
     if (m_Socket && !m_Socket->IsClosed() && m_anticheat)
@@ -368,12 +423,12 @@ bool WorldSession::Update(uint32 /*diff*/)
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !recvQueueCopy.empty())
+    for (auto& packet : m_recvQueueProcessing)
     {
-        // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
+        if (!m_Socket || m_Socket->IsClosed())
+            break;
 
-        auto const packet = std::move(recvQueueCopy.front());
-        recvQueueCopy.pop_front();
+        // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
         switch (opHandle.status)
@@ -443,7 +498,10 @@ bool WorldSession::Update(uint32 /*diff*/)
                               packet->GetOpcode());
                 break;
         }
+
+        RecyclePacket(std::move(packet));
     }
+    m_recvQueueProcessing.clear();
 
 #ifdef BUILD_DEPRECATED_PLAYERBOT
     // Process player bot packets
@@ -457,14 +515,18 @@ bool WorldSession::Update(uint32 /*diff*/)
         {
             Player* const botPlayer = itr->second;
             WorldSession* const pBotWorldSession = botPlayer->GetSession();
-            while(!pBotWorldSession->m_recvQueue.empty())
             {
-                auto const botpacket = std::move(pBotWorldSession->m_recvQueue.front());
-                pBotWorldSession->m_recvQueue.pop_front();
+                std::lock_guard<std::mutex> guard(pBotWorldSession->m_recvQueueLock);
+                std::swap(pBotWorldSession->m_recvQueueProcessing, pBotWorldSession->m_recvQueue);
+            }
 
+            for (auto& botpacket : pBotWorldSession->m_recvQueueProcessing)
+            {
                 OpcodeHandler const& opHandle = opcodeTable[botpacket->GetOpcode()];
                 pBotWorldSession->ExecuteOpcode(opHandle, *botpacket);
+                pBotWorldSession->RecyclePacket(std::move(botpacket));
             }
+            pBotWorldSession->m_recvQueueProcessing.clear();
         }
         GetPlayer()->GetPlayerbotMgr()->RemoveBots();
     }
@@ -553,16 +615,15 @@ bool WorldSession::Update(uint32 /*diff*/)
 
 void WorldSession::UpdateMap(uint32 diff)
 {
-    std::deque<std::unique_ptr<WorldPacket>> recvQueueMapCopy;
     {
         std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
-        std::swap(recvQueueMapCopy, m_recvQueueMap);
+        std::swap(m_recvQueueMapProcessing, m_recvQueueMap);
     }
 
-    while (m_Socket && !m_Socket->IsClosed() && recvQueueMapCopy.size())
+    for (auto& packet : m_recvQueueMapProcessing)
     {
-        auto const packet = std::move(recvQueueMapCopy.front());
-        recvQueueMapCopy.pop_front();
+        if (!m_Socket || m_Socket->IsClosed())
+            break;
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
         
@@ -570,7 +631,10 @@ void WorldSession::UpdateMap(uint32 diff)
         {
             ExecuteOpcode(opHandle, *packet);
         }
+
+        RecyclePacket(std::move(packet));
     }
+    m_recvQueueMapProcessing.clear();
 }
 
 /// %Log the player out
@@ -580,6 +644,8 @@ void WorldSession::LogoutPlayer()
     if (m_playerRecentlyLogout)
         return;
 
+    SqlOrderingKey orderingKey(GetAccountId());
+
     // finish pending transfers before starting the logout
     while (_player && _player->IsBeingTeleportedFar())
         HandleMoveWorldportAckOpcode();
@@ -697,13 +763,18 @@ void WorldSession::LogoutPlayer()
         ///- Leave all channels before player delete...
         _player->CleanupChannels();
 
-        ///- If the player is in a group (or invited), remove him. If the group if then only 1 person, disband the group.
-        _player->UninviteFromGroup();
+        {
+            // group rows are shared with the other members
+            SqlOrderingKey sharedOrderingKey(0);
+
+            ///- If the player is in a group (or invited), remove him. If the group if then only 1 person, disband the group.
+            _player->UninviteFromGroup();
 
-        // remove player from the group if he is:
-        // a) in group; b) not in raid group; c) logging out normally (not being kicked or disconnected)
-        if (_player->GetGroup() && !_player->GetGroup()->IsRaidGroup() && m_Socket && !m_Socket->IsClosed())
-            _player->RemoveFromGroup();
+            // remove player from the group if he is:
+            // a) in group; b) not in raid group; c) logging out normally (not being kicked or disconnected)
+            if (_player->GetGroup() && !_player->GetGroup()->IsRaidGroup() && m_Socket && !m_Socket->IsClosed())
+                _player->RemoveFromGroup();
+        }
 
         ///- Send update to group
         if (Group* group = _player->GetGroup())
@@ -1160,8 +1231,90 @@ void WorldSession::SendRedirectClient(std::string& ip, uint16 port) const
     SendPacket(pkt);
 }
 
+// true for handlers writing rows shared with other accounts (guilds, guild banks, mail, auctions, groups...)
+static bool IsSharedRowsOpcode(uint16 opcode)
+{
+    switch (opcode)
+    {
+        case CMSG_GUILD_CREATE:
+        case CMSG_GUILD_ACCEPT:
+        case CMSG_GUILD_PROMOTE:
+        case CMSG_GUILD_DEMOTE:
+        case CMSG_GUILD_LEAVE:
+        case CMSG_GUILD_REMOVE:
+        case CMSG_GUILD_DISBAND:
+        case CMSG_GUILD_LEADER:
+        case CMSG_GUILD_MOTD:
+        case CMSG_GUILD_RANK:
+        case CMSG_GUILD_ADD_RANK:
+        case CMSG_GUILD_DEL_RANK:
+        case CMSG_GUILD_SET_PUBLIC_NOTE:
+        case CMSG_GUILD_SET_OFFICER_NOTE:
+        case CMSG_GUILD_INFO_TEXT:
+        case MSG_SAVE_GUILD_EMBLEM:
+        case CMSG_GUILD_BANK_SWAP_ITEMS:
+        case CMSG_GUILD_BANK_BUY_TAB:
+        case CMSG_GUILD_BANK_UPDATE_TAB:
+        case CMSG_GUILD_BANK_DEPOSIT_MONEY:
+        case CMSG_GUILD_BANK_WITHDRAW_MONEY:
+        case CMSG_SET_GUILD_BANK_TEXT:
+        case CMSG_PETITION_BUY:
+        case CMSG_PETITION_SIGN:
+        case MSG_PETITION_DECLINE:
+        case CMSG_OFFER_PETITION:
+        case CMSG_TURN_IN_PETITION:
+        case MSG_PETITION_RENAME:
+        case CMSG_SEND_MAIL:
+        case CMSG_MAIL_TAKE_MONEY:
+        case CMSG_MAIL_TAKE_ITEM:
+        case CMSG_MAIL_MARK_AS_READ:
+        case CMSG_MAIL_RETURN_TO_SENDER:
+        case CMSG_MAIL_DELETE:
+        case CMSG_MAIL_CREATE_TEXT_ITEM:
+        case CMSG_AUCTION_SELL_ITEM:
+        case CMSG_AUCTION_REMOVE_ITEM:
+        case CMSG_AUCTION_PLACE_BID:
+        case CMSG_ARENA_TEAM_CREATE:
+        case CMSG_ARENA_TEAM_ACCEPT:
+        case CMSG_ARENA_TEAM_LEAVE:
+        case CMSG_ARENA_TEAM_REMOVE:
+        case CMSG_ARENA_TEAM_DISBAND:
+        case CMSG_ARENA_TEAM_LEADER:
+        case CMSG_GROUP_ACCEPT:
+        case CMSG_GROUP_UNINVITE:
+        case CMSG_GROUP_UNINVITE_GUID:
+        case CMSG_GROUP_SET_LEADER:
+        case CMSG_GROUP_DISBAND:
+        case CMSG_GROUP_CHANGE_SUB_GROUP:
+        case CMSG_GROUP_SWAP_SUB_GROUP:
+        case CMSG_GROUP_RAID_CONVERT:
+        case CMSG_GROUP_ASSISTANT_LEADER:
+        case MSG_PARTY_ASSIGNMENT:
+        case CMSG_LOOT_METHOD:
+        case CMSG_LOOT_MASTER_GIVE:
+        case CMSG_ACCEPT_TRADE:
+        case CMSG_REPAIR_ITEM:                              // may be paid from the guild bank
+        case CMSG_CALENDAR_ADD_EVENT:
+        case CMSG_CALENDAR_UPDATE_EVENT:
+        case CMSG_CALENDAR_REMOVE_EVENT:
+        case CMSG_CALENDAR_COPY_EVENT:
+        case CMSG_CALENDAR_EVENT_INVITE:
+        case CMSG_CALENDAR_EVENT_RSVP:
+        case CMSG_CALENDAR_EVENT_REMOVE_INVITE:
+        case CMSG_CALENDAR_EVENT_STATUS:
+        case CMSG_CALENDAR_EVENT_MODERATOR_STATUS:
+        case CMSG_CALENDAR_EVENT_SIGNUP:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet)
 {
+    // async DB requests on rows of other accounts use the shared key, ordered against the requests of every account
+    SqlOrderingKey orderingKey(IsSharedRowsOpcode(packet.GetOpcode()) ? 0 : SqlOrderingKey::GetCurrent());
+
     // need prevent do internal far teleports in handlers because some handlers do lot steps
     // or call code that can do far teleports in some conditions unexpectedly for generic way work code
     if (_player)
@@ -267,6 +267,8 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const& packet) const;
+        // packet is shared with other sessions and sent without copying it
+        void SendPacket(std::shared_ptr<WorldPacket const> const& packet) const;
         void SendExpectedSpamRecords();
         void SendMotd();
         void SendOfflineNameQueryResponses();
@@ -351,6 +353,11 @@ class WorldSession
 
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
 
+        // inbound packets are recycled per session instead of allocated for every client message
+        std::unique_ptr<WorldPacket> AcquirePacket(uint16 opcode, size_t size);
+        void RecyclePacket(std::unique_ptr<WorldPacket> packet);
+        void ResetPacketPoolCounters(uint32& allocated, uint32& reused);
+
         void DeleteMovementPackets();
 
         bool Update(uint32 diff);
@@ -427,7 +434,7 @@ class WorldSession
         void SendAuctionRemovedNotification(AuctionEntry* auction) const;
         static void SendAuctionOutbiddedMail(AuctionEntry* auction);
         static void SendAuctionCancelledToBidderMail(AuctionEntry* auction);
-        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
+        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, AuctionSorter const& sorter, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
                                    uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const;
 
         AuctionHouseEntry const* GetCheckedAuctionHouseForAuctioneer(ObjectGuid guid) const;
@@ -1023,6 +1030,7 @@ class WorldSession
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet);
+        bool PrepareSendPacket(WorldPacket const& packet) const;
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const;
@@ -1091,8 +1099,16 @@ class WorldSession
         // Thread safety mechanisms
         std::mutex m_recvQueueLock;
         std::mutex m_recvQueueMapLock;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueueMap;
+        std::vector<std::unique_ptr<WorldPacket>> m_recvQueue;
+        std::vector<std::unique_ptr<WorldPacket>> m_recvQueueMap;
+        // swapped with the queues above by their consumer, both keep their capacity between updates
+        std::vector<std::unique_ptr<WorldPacket>> m_recvQueueProcessing;
+        std::vector<std::unique_ptr<WorldPacket>> m_recvQueueMapProcessing;
+
+        std::mutex m_packetPoolLock;
+        std::vector<std::unique_ptr<WorldPacket>> m_packetPool;
+        std::atomic<uint32> m_packetsAllocated;
+        std::atomic<uint32> m_packetsReused;
 
         Messager<WorldSession> m_messager;
 
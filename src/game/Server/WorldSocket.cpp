@@ -122,31 +122,57 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     if (IsClosed())
         return;
 
-    if (sPacketLog->CanLogPacket() && IsLoggingPackets())
-        sPacketLog->LogPacket(pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
-
-    // Dump outgoing packet.
-    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
-
-    // encrypt thread unsafe due to being executed from map contexts frequently - TODO: move to post service context in future
-    std::lock_guard<std::mutex> guard(m_worldSocketMutex);
+    LogOutgoingPacket(pct);
 
     ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
-    m_crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
 
+    // header is encrypted by PrepareOutgoingHeader on the network thread
     if (!pct.empty())
         Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), reinterpret_cast<const char*>(pct.contents()), pct.size());
     else
-        Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength());
+        Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), nullptr, 0);
 
     if (immediate)
         ForceFlushOut();
+}
+
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> const& pct, bool immediate)
+{
+    if (IsClosed())
+        return;
+
+    LogOutgoingPacket(*pct);
+
+    ServerPktHeader header(pct->size() + 2, pct->GetOpcode());
+
+    // the packet content is not copied, the socket holds a reference until it was sent
+    Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), SharedContent{ pct->contents(), pct->size(), pct });
+
+    if (immediate)
+        ForceFlushOut();
+}
+
+void WorldSocket::LogOutgoingPacket(const WorldPacket& pct)
+{
+    if (sPacketLog->CanLogPacket() && IsLoggingPackets())
+        sPacketLog->LogPacket(pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
+
+    std::lock_guard<std::mutex> guard(m_worldSocketMutex);
 
     m_opcodeHistoryOut.push_front(uint32(pct.GetOpcode()));
     if (m_opcodeHistoryOut.size() > 50)
         m_opcodeHistoryOut.resize(30);
 }
 
+void WorldSocket::PrepareOutgoingHeader(uint8* header, size_t length)
+{
+    // always called on the network thread in send order, so the stream cipher needs no lock
+    m_crypt.EncryptSend(header, length);
+}
+
 bool WorldSocket::Open()
 {
     if (!Socket::Open())
@@ -229,7 +255,7 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    std::unique_ptr<WorldPacket> pct(m_session ? m_session->AcquirePacket(opcode, validBytesRemaining) : std::unique_ptr<WorldPacket>(new WorldPacket(opcode, validBytesRemaining)));
 
     if (validBytesRemaining)
     {
@@ -33,6 +33,7 @@
 #include <chrono>
 #include <functional>
 #include <deque>
+#include <memory>
 
 class WorldPacket;
 class WorldSession;
@@ -121,6 +122,12 @@ class WorldSocket : public MaNGOS::Socket
         /// Called by ProcessIncoming() on CMSG_PING.
         bool HandlePing(WorldPacket& recvPacket);
 
+        /// Packet log, dump and opcode history of a sent packet.
+        void LogOutgoingPacket(const WorldPacket& pct);
+
+        /// Encrypts the headers of queued packets right before they are sent.
+        virtual void PrepareOutgoingHeader(uint8* header, size_t length) override;
+
         std::mutex m_worldSocketMutex;
 
         std::deque<uint32> m_opcodeHistoryOut;
@@ -133,6 +140,8 @@ class WorldSocket : public MaNGOS::Socket
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct, bool immediate = false);
+        // send a packet shared between several sockets without copying it, it must not change anymore
+        void SendPacket(std::shared_ptr<WorldPacket const> const& pct, bool immediate = false);
 
         void FinalizeSession() { m_session = nullptr; }
 
@@ -79,6 +79,9 @@ bool PlayerSocial::AddToSocialList(ObjectGuid friend_guid, bool ignore)
         fi.Flags |= flag;
         m_playerSocialMap[friend_guid.GetCounter()] = fi;
     }
+
+    if (!ignore)
+        sSocialMgr.AddFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
     return true;
 }
 
@@ -92,6 +95,9 @@ void PlayerSocial::RemoveFromSocialList(ObjectGuid friend_guid, bool ignore)
     if (ignore)
         flag = SOCIAL_FLAG_IGNORED;
 
+    if (!ignore && (itr->second.Flags & SOCIAL_FLAG_FRIEND))
+        sSocialMgr.RemoveFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
+
     itr->second.Flags &= ~flag;
     if (itr->second.Flags == 0)
     {
@@ -176,6 +182,37 @@ SocialMgr::~SocialMgr()
 {
 }
 
+void SocialMgr::RemovePlayerSocial(uint32 guid)
+{
+    SocialMap::iterator itr = m_socialMap.find(guid);
+    if (itr == m_socialMap.end())
+        return;
+
+    for (auto& friendItr : itr->second.m_playerSocialMap)
+        if (friendItr.second.Flags & SOCIAL_FLAG_FRIEND)
+            RemoveFriendLister(friendItr.first, guid);
+
+    m_socialMap.erase(itr);
+}
+
+void SocialMgr::AddFriendLister(uint32 friendGuid, uint32 listerGuid)
+{
+    std::lock_guard<std::mutex> guard(m_friendListersLock);
+    m_friendListers[friendGuid].insert(listerGuid);
+}
+
+void SocialMgr::RemoveFriendLister(uint32 friendGuid, uint32 listerGuid)
+{
+    std::lock_guard<std::mutex> guard(m_friendListersLock);
+    FriendListersMap::iterator itr = m_friendListers.find(friendGuid);
+    if (itr == m_friendListers.end())
+        return;
+
+    itr->second.erase(listerGuid);
+    if (itr->second.empty())
+        m_friendListers.erase(itr);
+}
+
 void SocialMgr::GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const
 {
     if (!player)
@@ -273,22 +310,53 @@ void SocialMgr::BroadcastToFriendListers(Player* player, WorldPacket const& pack
     AccountTypes gmLevelInWhoList = AccountTypes(sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST));
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
 
-    for (SocialMap::const_iterator itr = m_socialMap.begin(); itr != m_socialMap.end(); ++itr)
+    ///- Only the loaded players having this player in their friend list are visited
+    std::vector<uint32> listers;
     {
-        PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.find(guid);
-        if (itr2 != itr->second.m_playerSocialMap.end() && (itr2->second.Flags & SOCIAL_FLAG_FRIEND))
+        std::lock_guard<std::mutex> guard(m_friendListersLock);
+        FriendListersMap::const_iterator itr = m_friendListers.find(guid);
+        if (itr != m_friendListers.end())
+            listers.assign(itr->second.begin(), itr->second.end());
+    }
+
+    std::vector<uint32> receivers;
+    for (uint32 lister : listers)
+    {
+        Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, lister));
+
+        // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
+        // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
+        if (pFriend && pFriend->IsInWorld() &&
+                (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
+                 ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
+                player->IsVisibleGloballyFor(pFriend))
         {
-            Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
-
-            // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
-            // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
-            if (pFriend && pFriend->IsInWorld() &&
-                    (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
-                     ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
-                    player->IsVisibleGloballyFor(pFriend))
-            {
-                pFriend->GetSession()->SendPacket(packet);
-            }
+            receivers.push_back(lister);
+        }
+    }
+
+    ///- Queue for the end of the tick, an earlier status of this player in the same tick is outdated
+    std::lock_guard<std::mutex> guard(m_queuedFriendStatusLock);
+    QueuedFriendStatus& queued = m_queuedFriendStatus[guid];
+    queued.packet = packet;
+    queued.receivers = std::move(receivers);
+}
+
+void SocialMgr::SendQueuedFriendStatus()
+{
+    std::map<uint32, QueuedFriendStatus> queuedFriendStatus;
+    {
+        std::lock_guard<std::mutex> guard(m_queuedFriendStatusLock);
+        queuedFriendStatus.swap(m_queuedFriendStatus);
+    }
+
+    for (auto& queued : queuedFriendStatus)
+    {
+        for (uint32 receiver : queued.second.receivers)
+        {
+            Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, receiver));
+            if (pFriend && pFriend->IsInWorld())
+                pFriend->GetSession()->SendPacket(queued.second.packet);
         }
     }
 }
@@ -298,9 +366,23 @@ PlayerSocial* SocialMgr::LoadFromDB(std::unique_ptr<QueryResult> queryResult, Ob
     PlayerSocial* social = &m_socialMap[guid.GetCounter()];
     social->SetPlayerGuid(guid);
 
-    if (!queryResult)
-        return social;
+    // entries left from an earlier login may change below, they are indexed again once loaded
+    for (auto& friendItr : social->m_playerSocialMap)
+        if (friendItr.second.Flags & SOCIAL_FLAG_FRIEND)
+            RemoveFriendLister(friendItr.first, guid.GetCounter());
+
+    if (queryResult)
+        LoadSocialList(std::move(queryResult), social);
 
+    for (auto& friendItr : social->m_playerSocialMap)
+        if (friendItr.second.Flags & SOCIAL_FLAG_FRIEND)
+            AddFriendLister(friendItr.first, guid.GetCounter());
+
+    return social;
+}
+
+void SocialMgr::LoadSocialList(std::unique_ptr<QueryResult> queryResult, PlayerSocial* social)
+{
     // used to speed up check below. Using GetNumberOfSocialsWithFlag will cause unneeded iteration
     uint32 friendCounter = 0, ignoreCounter = 0;
 
@@ -325,5 +407,4 @@ PlayerSocial* SocialMgr::LoadFromDB(std::unique_ptr<QueryResult> queryResult, Ob
             ++friendCounter;
     }
     while (queryResult->NextRow());
-    return social;
 }
@@ -21,6 +21,10 @@
 
 #include "Database/DatabaseEnv.h"
 #include "Entities/ObjectGuid.h"
+#include "Server/WorldPacket.h"
+
+#include <mutex>
+#include <unordered_map>
 
 class SocialMgr;
 class PlayerSocial;
@@ -73,6 +77,7 @@ struct FriendInfo
 
 typedef std::map<uint32, FriendInfo> PlayerSocialMap;
 typedef std::map<uint32, PlayerSocial> SocialMap;
+typedef std::unordered_map<uint32, std::set<uint32>> FriendListersMap;     // friend lowguid -> lowguids of loaded players listing him as friend
 
 /// Results of friend related commands
 enum FriendsResult
@@ -133,21 +138,39 @@ class PlayerSocial
 
 class SocialMgr
 {
+        friend class PlayerSocial;
     public:
         SocialMgr();
         ~SocialMgr();
         // Misc
-        void RemovePlayerSocial(uint32 guid) { m_socialMap.erase(guid); }
+        void RemovePlayerSocial(uint32 guid);
 
         void GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const;
         // Packet management
         static void MakeFriendStatusPacket(FriendsResult result, uint32 guid, WorldPacket& data);
         void SendFriendStatus(Player* player, FriendsResult result, ObjectGuid friend_guid, bool broadcast);
         void BroadcastToFriendListers(Player* player, WorldPacket const& packet);
+        // Sends the broadcasts queued since the last call, once per world tick
+        void SendQueuedFriendStatus();
         // Loading
         PlayerSocial* LoadFromDB(std::unique_ptr<QueryResult> queryResult, ObjectGuid guid);
     private:
+        void LoadSocialList(std::unique_ptr<QueryResult> queryResult, PlayerSocial* social);
+        void AddFriendLister(uint32 friendGuid, uint32 listerGuid);
+        void RemoveFriendLister(uint32 friendGuid, uint32 listerGuid);
+
+        // last status broadcast of a player in the current tick, replaced by any later one
+        struct QueuedFriendStatus
+        {
+            WorldPacket packet;
+            std::vector<uint32> receivers;
+        };
+
         SocialMap m_socialMap;
+        FriendListersMap m_friendListers;
+        std::mutex m_friendListersLock;
+        std::map<uint32, QueuedFriendStatus> m_queuedFriendStatus;
+        std::mutex m_queuedFriendStatusLock;
 };
 
 #define sSocialMgr MaNGOS::Singleton<SocialMgr>::Instance()
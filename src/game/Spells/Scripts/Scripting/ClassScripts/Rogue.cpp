@@ -315,7 +315,10 @@ struct GlyphOfSafeFall : public AuraScript
     void OnApply(Aura* aura, bool apply) const override
     {
         if (Aura* safeFall = aura->GetTarget()->GetAura(1860, EFFECT_INDEX_0))
+        {
             safeFall->GetModifier()->m_amount += (apply ? aura->GetAmount() : -aura->GetAmount());
+            aura->GetTarget()->InvalidateAuraModifierTotals(safeFall->GetModifier()->m_auraname);
+        }
     }
 };
 
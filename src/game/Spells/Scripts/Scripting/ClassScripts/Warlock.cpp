@@ -348,6 +348,7 @@ struct SeedOfCorruption : public AuraScript
 
         // Damage counting
         mod->m_amount -= procData.damage;
+        procData.triggeredByAura->GetTarget()->InvalidateAuraModifierTotals(mod->m_auraname);
         return SPELL_AURA_PROC_OK;
     }
 };
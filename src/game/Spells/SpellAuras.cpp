@@ -918,12 +918,20 @@ void Aura::ApplyModifier(bool apply, bool Real)
 {
     AuraType aura = m_modifier.m_auraname;
 
+    // amount may have been changed since last apply
+    if (aura < TOTAL_AURAS)
+        GetTarget()->InvalidateAuraModifierTotals(aura);
+
     if (apply)
         OnApply(apply);
     if (!apply)
         OnAfterApply(apply);
     if (aura < TOTAL_AURAS)
+    {
         (*this.*AuraHandler [aura])(apply, Real);
+        // handlers are allowed to adjust the amount
+        GetTarget()->InvalidateAuraModifierTotals(aura);
+    }
     if (apply)
         OnAfterApply(apply);
     if (!apply)
@@ -1781,6 +1789,7 @@ void Aura::TriggerSpell()
                                 UnitMods unitMod = UnitMods(UNIT_MOD_POWER_START + m_modifier.m_miscvalue);
                                 GetTarget()->HandleStatModifier(unitMod, TOTAL_PCT, float(aura->m_modifier.m_amount), false);
                                 aura->m_modifier.m_amount -= 5;
+                                GetTarget()->InvalidateAuraModifierTotals(aura->m_modifier.m_auraname);
                                 GetTarget()->HandleStatModifier(unitMod, TOTAL_PCT, float(aura->m_modifier.m_amount), true);
                             }
                         }
@@ -1984,6 +1993,7 @@ void Aura::TriggerSpell()
                         if (triggerTarget->IsMoving())
                         {
                             m_modifier.m_amount = 6;
+                            GetTarget()->InvalidateAuraModifierTotals(m_modifier.m_auraname);
                             return;
                         }
 
@@ -1991,6 +2001,7 @@ void Aura::TriggerSpell()
                         if (m_modifier.m_amount > 0)
                         {
                             --m_modifier.m_amount;
+                            GetTarget()->InvalidateAuraModifierTotals(m_modifier.m_auraname);
                             return;
                         }
 
@@ -4042,6 +4053,7 @@ void Aura::HandleAuraModShapeshift(bool apply, bool Real)
                 if (Aura* threatAura = defianceHolder->m_auras[0])
                 {
                     threatAura->GetModifier()->m_amount = apply ? threatAura->GetModifier()->m_baseAmount : 0;
+                    target->InvalidateAuraModifierTotals(threatAura->GetModifier()->m_auraname);
                     for (int8 x = 0; x < MAX_SPELL_SCHOOL; ++x)
                         if (threatAura->GetModifier()->m_miscvalue & int32(1 << x))
                             ApplyPercentModFloatVar(target->m_threatModifier[x], float(threatAura->GetModifier()->m_baseAmount), apply);
@@ -8107,12 +8119,16 @@ void Aura::PeriodicTick()
                 case 40932: // Agonizing Flames - Illidan
                 {
                     if (GetAuraTicks() % 3 == 0) // increased damage after every 3rd tick
+                    {
                         m_modifier.m_amount += m_modifier.m_baseAmount;
+                        target->InvalidateAuraModifierTotals(m_modifier.m_auraname);
+                    }
                     break;
                 }
                 case 41337: // Aura of Anger
                 {
                     m_modifier.m_amount += m_modifier.m_baseAmount;
+                    target->InvalidateAuraModifierTotals(m_modifier.m_auraname);
                     if (Aura* aura = GetHolder()->m_auras[EFFECT_INDEX_1])
                     {
                         aura->ApplyModifier(false, true);
@@ -9759,6 +9775,9 @@ SpellAuraHolder::SpellAuraHolder(SpellEntry const* spellproto, Unit* target, Wor
     m_trackedAuraType = sSpellMgr.IsSingleTargetSpell(spellproto) ? TRACK_AURA_TYPE_SINGLE_TARGET : IsSpellHaveAura(spellproto, SPELL_AURA_CONTROL_VEHICLE) ? TRACK_AURA_TYPE_CONTROL_VEHICLE : TRACK_AURA_TYPE_NOT_TRACKED;
     m_procCharges    = spellproto->procCharges;
 
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(spellproto->Id);
+    m_procTriggerFlags = spellProcEvent && spellProcEvent->procFlags ? spellProcEvent->procFlags : spellproto->procFlags;
+
     m_isRemovedOnShapeLost = IsRemovedOnShapeshiftLost(m_spellProto, GetCasterGuid(), target->GetObjectGuid());
 
     Unit* unitCaster = caster && caster->isType(TYPEMASK_UNIT) ? (Unit*)caster : nullptr;
@@ -10263,6 +10282,10 @@ void SpellAuraHolder::BuildUpdatePacket(WorldPacket& data) const
 
 void SpellAuraHolder::SendAuraUpdate(bool remove) const
 {
+    // refreshed durations, stacks and charges are saved with the character
+    if (m_target->GetTypeId() == TYPEID_PLAYER)
+        static_cast<Player*>(m_target)->SetAurasChanged();
+
     WorldPacket data(SMSG_AURA_UPDATE);
     data << m_target->GetPackGUID();
 
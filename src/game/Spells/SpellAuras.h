@@ -167,6 +167,7 @@ class SpellAuraHolder
         uint8 GetAuraLevel() const { return m_auraLevel; }
         void SetAuraLevel(uint8 level) { m_auraLevel = level; }
         uint32 GetAuraCharges() const { return m_procCharges; }
+        uint32 GetProcTriggerFlags() const { return m_procTriggerFlags; }
         void SetAuraCharges(uint32 charges, bool update = true)
         {
             if (m_procCharges == charges)
@@ -232,6 +233,7 @@ class SpellAuraHolder
         uint8 m_auraFlags;                                  // Aura info flag (for send data to client)
         uint8 m_auraLevel;                                  // Aura level (store caster level for correct show level dep amount)
         uint32 m_procCharges;                               // Aura charges (0 for infinite)
+        uint32 m_procTriggerFlags;                          // Proc flags from spell_proc_event or the spell, 0 if the holder can't proc
         uint32 m_stackAmount;                               // Aura stack amount
         int32 m_maxDuration;                                // Max aura duration
         int32 m_duration;                                   // Current time
@@ -532,16 +532,61 @@ ProcExecutionData::ProcExecutionData(ProcSystemArguments& data, bool isVictim) :
     }
 }
 
+void Unit::UpdateProcAuraHolders(SpellAuraHolder* holder, bool add)
+{
+    uint32 procFlags = holder->GetProcTriggerFlags();
+    if (!procFlags)
+        return;
+
+    if (add)
+        m_procAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    else
+    {
+        SpellAuraHolderBounds bounds = m_procAuraHolders.equal_range(holder->GetId());
+        for (SpellAuraHolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
+        {
+            if (itr->second == holder)
+            {
+                m_procAuraHolders.erase(itr);
+                break;
+            }
+        }
+    }
+
+    for (uint32 i = 0; i < 32; ++i)
+    {
+        if (!(procFlags & (1u << i)))
+            continue;
+
+        if (add)
+            ++m_procAuraHolderCount[i];
+        else
+            --m_procAuraHolderCount[i];
+
+        if (m_procAuraHolderCount[i])
+            m_procAuraFlags |= (1u << i);
+        else
+            m_procAuraFlags &= ~(1u << i);
+    }
+}
+
 void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
 {
     ProcExecutionData execData(argData, isVictim);
 
+    // no holder can proc from this event
+    if (!(execData.procFlags & m_procAuraFlags))
+        return;
+
     ProcTriggeredList procTriggered;
     std::vector<SpellAuraHolder*> holdersForDeletion;
-    // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    // Fill procTriggered list, only holders with proc flags of this event are of interest
+    for (SpellAuraHolderMap::const_iterator itr = m_procAuraHolders.begin(); itr != m_procAuraHolders.end(); ++itr)
     {
         SpellAuraHolder* holder = itr->second;
+        if (!(holder->GetProcTriggerFlags() & execData.procFlags))
+            continue;
+
         // skip deleted auras (possible at recursive triggered call
         if (holder->GetState() != SPELLAURAHOLDER_STATE_READY || holder->IsDeleted())
             continue;
@@ -1527,6 +1572,7 @@ SpellAuraProcResult Unit::HandleDummyAuraProc(ProcExecutionData& data)
                 if (procEx & PROC_EX_CRITICAL_HIT)
                 {
                     mod->m_amount *= 2;
+                    InvalidateAuraModifierTotals(mod->m_auraname);
                     if (mod->m_amount < 100) // not enough
                         return SPELL_AURA_PROC_OK;
                     // Critical counted -> roll chance
@@ -1534,6 +1580,7 @@ SpellAuraProcResult Unit::HandleDummyAuraProc(ProcExecutionData& data)
                         CastSpell(this, 48108, TRIGGERED_OLD_TRIGGERED, castItem, triggeredByAura);
                 }
                 mod->m_amount = 25;
+                InvalidateAuraModifierTotals(mod->m_auraname);
                 return SPELL_AURA_PROC_OK;
             }
             // Burnout
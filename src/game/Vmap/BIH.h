@@ -117,9 +117,123 @@ class BIH
             delete[] dat.indices;
         }
         size_t primCount() const { return objects.size(); }
+        //! primitive stored at a leaf slot; leaves cover consecutive slots
+        uint32 primIndex(uint32 slot) const { return objects[slot]; }
 
         template<typename RayCallback>
         void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false, bool ignoreM2Model = false) const
+        {
+            auto leafFunc = [&](uint32 offset, uint32 count) -> bool
+            {
+                for (; count > 0; --count, ++offset)
+                {
+                    bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst, ignoreM2Model);
+                    if (stopAtFirst && hit)
+                        return true;
+                }
+                return false;
+            };
+            traverseRay(r, leafFunc, maxDist);
+        }
+
+        //! same as intersectRay, but the callback receives whole leaves as (ray, firstSlot, slotCount, maxDist)
+        template<typename LeafCallback>
+        void intersectRayLeaves(const Ray& r, LeafCallback& leafCallback, float& maxDist, bool stopAtFirst = false) const
+        {
+            auto leafFunc = [&](uint32 offset, uint32 count) -> bool
+            {
+                bool hit = leafCallback(r, offset, count, maxDist);
+                return stopAtFirst && hit;
+            };
+            traverseRay(r, leafFunc, maxDist);
+        }
+
+        template<typename IsectCallback>
+        void intersectPoint(const Vector3& p, IsectCallback& intersectCallback) const
+        {
+            if (!bounds.contains(p))
+                return;
+
+            StackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    const bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float tl = intBitsToFloat(tree[node + 1]);
+                            float tr = intBitsToFloat(tree[node + 2]);
+                            // point is between clip zones
+                            if (tl < p[axis] && tr > p[axis])
+                                break;
+                            int right = offset + 3;
+                            node = right;
+                            // point is in right node only
+                            if (tl < p[axis])
+                            {
+                                continue;
+                            }
+                            node = offset; // left
+                            // point is in left node only
+                            if (tr > p[axis])
+                            {
+                                continue;
+                            }
+                            // point is in both nodes
+                            // push back right node
+                            stack[stackPos].node = right;
+                            ++stackPos;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0)
+                            {
+                                intersectCallback(p, objects[offset]); // !!!
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else // BVH2 node (empty space cut off left and right)
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        float tl = intBitsToFloat(tree[node + 1]);
+                        float tr = intBitsToFloat(tree[node + 2]);
+                        node = offset;
+                        if (tl > p[axis] || tr < p[axis])
+                            break;
+                    }
+                } // traversal loop
+
+                // stack is empty?
+                if (stackPos == 0)
+                    return;
+                // move back up the stack
+                --stackPos;
+                node = stack[stackPos].node;
+            }
+        }
+
+        bool writeToFile(FILE* wf) const;
+        bool readFromFile(FILE* rf);
+
+    protected:
+        template<typename LeafFunc>
+        void traverseRay(const Ray& r, LeafFunc& leafFunc, float& maxDist) const
         {
             float intervalMin = -1.f;
             float intervalMax = -1.f;
@@ -218,14 +332,9 @@ class BIH
                         else
                         {
                             // leaf - test some objects
-                            int n = tree[node + 1];
-                            while (n > 0)
-                            {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst, ignoreM2Model);
-                                if (stopAtFirst && hit) return;
-                                --n;
-                                ++offset;
-                            }
+                            uint32 n = tree[node + 1];
+                            if (n > 0 && leafFunc(offset, n))
+                                return;
                             break;
                         }
                     }
@@ -259,90 +368,6 @@ class BIH
             }
         }
 
-        template<typename IsectCallback>
-        void intersectPoint(const Vector3& p, IsectCallback& intersectCallback) const
-        {
-            if (!bounds.contains(p))
-                return;
-
-            StackNode stack[MAX_STACK_SIZE];
-            int stackPos = 0;
-            int node = 0;
-
-            while (true)
-            {
-                while (true)
-                {
-                    uint32 tn = tree[node];
-                    uint32 axis = (tn & (3 << 30)) >> 30;
-                    const bool BVH2 = (tn & (1 << 29)) != 0;
-                    int offset = tn & ~(7 << 29);
-                    if (!BVH2)
-                    {
-                        if (axis < 3)
-                        {
-                            // "normal" interior node
-                            float tl = intBitsToFloat(tree[node + 1]);
-                            float tr = intBitsToFloat(tree[node + 2]);
-                            // point is between clip zones
-                            if (tl < p[axis] && tr > p[axis])
-                                break;
-                            int right = offset + 3;
-                            node = right;
-                            // point is in right node only
-                            if (tl < p[axis])
-                            {
-                                continue;
-                            }
-                            node = offset; // left
-                            // point is in left node only
-                            if (tr > p[axis])
-                            {
-                                continue;
-                            }
-                            // point is in both nodes
-                            // push back right node
-                            stack[stackPos].node = right;
-                            ++stackPos;
-                        }
-                        else
-                        {
-                            // leaf - test some objects
-                            int n = tree[node + 1];
-                            while (n > 0)
-                            {
-                                intersectCallback(p, objects[offset]); // !!!
-                                --n;
-                                ++offset;
-                            }
-                            break;
-                        }
-                    }
-                    else // BVH2 node (empty space cut off left and right)
-                    {
-                        if (axis > 2)
-                            return; // should not happen
-                        float tl = intBitsToFloat(tree[node + 1]);
-                        float tr = intBitsToFloat(tree[node + 2]);
-                        node = offset;
-                        if (tl > p[axis] || tr < p[axis])
-                            break;
-                    }
-                } // traversal loop
-
-                // stack is empty?
-                if (stackPos == 0)
-                    return;
-                // move back up the stack
-                --stackPos;
-                node = stack[stackPos].node;
-            }
-        }
-
-        bool writeToFile(FILE* wf) const;
-        bool readFromFile(FILE* rf);
-
-    protected:
         std::vector<uint32> tree;
         std::vector<uint32> objects;
         AABox bounds;
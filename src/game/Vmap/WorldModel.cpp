@@ -22,6 +22,11 @@
 #include "ModelInstance.h"
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VMAP_SSE_KERNEL
+#include <emmintrin.h>
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -32,59 +37,150 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(MeshTriangle const& tri, std::vector<Vector3>::const_iterator points, G3D::Ray const& ray, float& distance)
-    {
 #define EPS 1e-5f
 
-        // See RTR2 ch. 13.7 for the algorithm.
+    // See RTR2 ch. 13.7 for the algorithm.
 
-        Vector3 const idx0 = points[tri.idx0];
-        Vector3 const e1 = points[tri.idx1] - idx0;
-        Vector3 const e2 = points[tri.idx2] - idx0;
-        Vector3 const p(ray.direction().cross(e2));
-        float a = e1.dot(p);
+    void MeshTriangleSoA::build(std::vector<Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, BIH const& tree)
+    {
+        uint32 count = tree.primCount();
+        stride = (count + 6) & ~3u;
+        data.assign(MAX_COMPONENTS * stride, 0.0f);
 
-        if (fabs(a) < EPS)
+        for (uint32 slot = 0; slot < count; ++slot)
         {
-            // Determinant is ill-conditioned; abort early
-            return false;
+            MeshTriangle const& tri = triangles[tree.primIndex(slot)];
+            Vector3 const& v0 = vertices[tri.idx0];
+            Vector3 const e1 = vertices[tri.idx1] - v0;
+            Vector3 const e2 = vertices[tri.idx2] - v0;
+            for (int i = 0; i < 3; ++i)
+            {
+                data[(V0_X + i) * stride + slot] = v0[i];
+                data[(E1_X + i) * stride + slot] = e1[i];
+                data[(E2_X + i) * stride + slot] = e2[i];
+            }
         }
+    }
 
-        float const f = 1.0f / a;
-        Vector3 const s(ray.origin() - idx0);
-        float const u = f * s.dot(p);
-
-        if ((u < 0.0f) || (u > 1.0f))
+#ifdef VMAP_SSE_KERNEL
+    bool MeshTriangleSoA::IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const
+    {
+        Vector3 const& org = ray.origin();
+        Vector3 const& dir = ray.direction();
+        __m128 const ox = _mm_set1_ps(org.x), oy = _mm_set1_ps(org.y), oz = _mm_set1_ps(org.z);
+        __m128 const dx = _mm_set1_ps(dir.x), dy = _mm_set1_ps(dir.y), dz = _mm_set1_ps(dir.z);
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const eps = _mm_set1_ps(EPS);
+        __m128 const absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128i const lanes = _mm_set_epi32(3, 2, 1, 0);
+        bool hit = false;
+
+        for (uint32 slot = first, end = first + count; slot < end; slot += 4)
         {
-            // We hit the plane of the m_geometry, but outside the m_geometry
-            return false;
+            __m128 valid = _mm_castsi128_ps(_mm_cmplt_epi32(lanes, _mm_set1_epi32(int32(end - slot))));
+
+            __m128 const v0x = _mm_loadu_ps(GetComponent(V0_X) + slot);
+            __m128 const v0y = _mm_loadu_ps(GetComponent(V0_Y) + slot);
+            __m128 const v0z = _mm_loadu_ps(GetComponent(V0_Z) + slot);
+            __m128 const e1x = _mm_loadu_ps(GetComponent(E1_X) + slot);
+            __m128 const e1y = _mm_loadu_ps(GetComponent(E1_Y) + slot);
+            __m128 const e1z = _mm_loadu_ps(GetComponent(E1_Z) + slot);
+            __m128 const e2x = _mm_loadu_ps(GetComponent(E2_X) + slot);
+            __m128 const e2y = _mm_loadu_ps(GetComponent(E2_Y) + slot);
+            __m128 const e2z = _mm_loadu_ps(GetComponent(E2_Z) + slot);
+
+            // p = dir x e2, a = e1 . p
+            __m128 const px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 const py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 const pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 const a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            // determinant is ill-conditioned
+            valid = _mm_and_ps(valid, _mm_cmpge_ps(_mm_and_ps(a, absMask), eps));
+            if (!_mm_movemask_ps(valid))
+                continue;
+
+            __m128 const f = _mm_div_ps(one, a);
+            __m128 const sx = _mm_sub_ps(ox, v0x);
+            __m128 const sy = _mm_sub_ps(oy, v0y);
+            __m128 const sz = _mm_sub_ps(oz, v0z);
+            __m128 const u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+            // hit the plane, but outside the triangle
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+            if (!_mm_movemask_ps(valid))
+                continue;
+
+            // q = s x e1
+            __m128 const qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            __m128 const qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            __m128 const qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            __m128 const v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+            __m128 const t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(distance))));
+
+            int mask = _mm_movemask_ps(valid);
+            if (!mask)
+                continue;
+
+            // keep the closest hit
+            float dist[4];
+            _mm_storeu_ps(dist, t);
+            for (int i = 0; i < 4; ++i)
+                if ((mask & (1 << i)) && dist[i] < distance)
+                    distance = dist[i];
+            hit = true;
         }
 
-        Vector3 const q(s.cross(e1));
-        float const v = f * ray.direction().dot(q);
+        return hit;
+    }
+#else
+    bool MeshTriangleSoA::IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const
+    {
+        Vector3 const& org = ray.origin();
+        Vector3 const& dir = ray.direction();
+        bool hit = false;
 
-        if ((v < 0.0f) || ((u + v) > 1.0f))
+        for (uint32 slot = first, end = first + count; slot < end; ++slot)
         {
-            // We hit the plane of the triangle, but outside the triangle
-            return false;
-        }
+            Vector3 const v0(GetComponent(V0_X)[slot], GetComponent(V0_Y)[slot], GetComponent(V0_Z)[slot]);
+            Vector3 const e1(GetComponent(E1_X)[slot], GetComponent(E1_Y)[slot], GetComponent(E1_Z)[slot]);
+            Vector3 const e2(GetComponent(E2_X)[slot], GetComponent(E2_Y)[slot], GetComponent(E2_Z)[slot]);
+            Vector3 const p(dir.cross(e2));
+            float const a = e1.dot(p);
 
-        float const t = f * e2.dot(q);
+            // determinant is ill-conditioned
+            if (fabs(a) < EPS)
+                continue;
 
-        if ((t > 0.0f) && (t < distance))
-        {
-            // This is a new hit, closer than the previous one
-            distance = t;
+            float const f = 1.0f / a;
+            Vector3 const s(org - v0);
+            float const u = f * s.dot(p);
 
-            /* baryCoord[0] = 1.0 - u - v;
-            baryCoord[1] = u;
-            baryCoord[2] = v; */
+            // hit the plane, but outside the triangle
+            if ((u < 0.0f) || (u > 1.0f))
+                continue;
 
-            return true;
+            Vector3 const q(s.cross(e1));
+            float const v = f * dir.dot(q);
+
+            if ((v < 0.0f) || ((u + v) > 1.0f))
+                continue;
+
+            float const t = f * e2.dot(q);
+
+            // keep the closest hit
+            if ((t > 0.0f) && (t < distance))
+            {
+                distance = t;
+                hit = true;
+            }
         }
-        // This hit is after the previous hit, so ignore it
-        return false;
+
+        return hit;
     }
+#endif
 
     class TriBoundFunc
     {
@@ -265,7 +361,7 @@ namespace VMAP
 
     GroupModel::GroupModel(GroupModel const& other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), meshTriangles(other.meshTriangles), iLiquid(nullptr)
     {
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
@@ -277,6 +373,7 @@ namespace VMAP
         triangles.swap(tri);
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
+        meshTriangles.build(vertices, triangles, meshTree);
     }
 
     bool GroupModel::writeToFile(FILE* wf)
@@ -332,6 +429,7 @@ namespace VMAP
         uint32 count = 0;
         triangles.clear();
         vertices.clear();
+        meshTriangles.clear();
         delete iLiquid;
         iLiquid = nullptr;
 
@@ -361,6 +459,8 @@ namespace VMAP
         // read mesh BIH
         if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
         if (result) result = meshTree.readFromFile(rf);
+        if (result && !triangles.empty())
+            meshTriangles.build(vertices, triangles, meshTree);
 
         // read liquid data
         if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
@@ -372,27 +472,24 @@ namespace VMAP
 
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle>& tris, const std::vector<Vector3>& vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) {}
-        bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/, bool /*ignoreM2Model*/)
+        GModelRayCallback(MeshTriangleSoA const& tris): triangles(tris), hit(false) {}
+        bool operator()(const G3D::Ray& ray, uint32 firstSlot, uint32 count, float& distance)
         {
-            bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
-            if (result)
+            if (triangles.IntersectRay(ray, firstSlot, count, distance))
                 hit = true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        MeshTriangleSoA const& triangles;
         bool hit;
     };
 
-    bool GroupModel::IntersectRay(G3D::Ray const& ray, float& distance, bool stopAtFirstHit, bool ignoreM2Model) const
+    bool GroupModel::IntersectRay(G3D::Ray const& ray, float& distance, bool stopAtFirstHit, bool /*ignoreM2Model*/) const
     {
         if (triangles.empty())
             return false;
 
-        GModelRayCallback callback(triangles, vertices);
-        meshTree.intersectRay(ray, callback, distance, stopAtFirstHit, ignoreM2Model);
+        GModelRayCallback callback(meshTriangles);
+        meshTree.intersectRayLeaves(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
     }
 
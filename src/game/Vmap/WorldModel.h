@@ -45,6 +45,24 @@ namespace VMAP
             uint32 idx2;
     };
 
+    /*! Triangles of a group model stored in BIH slot order as a structure of arrays
+        (first vertex and both edges per component), so that the triangles of a BIH
+        leaf can be ray tested several at a time */
+    class MeshTriangleSoA
+    {
+        public:
+            MeshTriangleSoA() : stride(0) {}
+            void build(std::vector<Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, BIH const& tree);
+            void clear() { data.clear(); stride = 0; }
+            //! tests slots [first, first + count) and shortens distance to the closest hit
+            bool IntersectRay(G3D::Ray const& ray, uint32 first, uint32 count, float& distance) const;
+        private:
+            enum Component { V0_X, V0_Y, V0_Z, E1_X, E1_Y, E1_Z, E2_X, E2_Y, E2_Z, MAX_COMPONENTS };
+            float const* GetComponent(Component c) const { return &data[c * stride]; }
+            std::vector<float> data; //!< MAX_COMPONENTS arrays of stride floats, padded so 4 wide loads never leave the array
+            uint32 stride;
+    };
+
     class WmoLiquid
     {
         public:
@@ -102,6 +120,7 @@ namespace VMAP
             std::vector<Vector3> vertices;
             std::vector<MeshTriangle> triangles;
             BIH meshTree;
+            MeshTriangleSoA meshTriangles;
             WmoLiquid* iLiquid;
 
 #ifdef MMAP_GENERATOR
@@ -39,6 +39,7 @@
 #include "Globals/ObjectMgr.h"
 #include "AI/EventAI/CreatureEventAIMgr.h"
 #include "Guilds/GuildMgr.h"
+#include "Social/SocialMgr.h"
 #include "Spells/SpellMgr.h"
 #include "Chat/Chat.h"
 #include "Server/DBCStores.h"
@@ -494,6 +495,8 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    setConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD, "Compression.Threshold", 100);
+    setConfig(CONFIG_UINT32_COMPRESSION_PARALLEL_MIN_RECEIVERS, "Compression.ParallelMinReceivers", 0);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
@@ -519,6 +522,8 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetGridCleanUpDelay(getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN));
 
+    setConfig(CONFIG_UINT32_GRID_PRELOAD_LOOKAHEAD, "GridPreload.LookAhead", 0);
+
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
@@ -645,6 +650,9 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    setConfig(CONFIG_BOOL_MAP_PARALLEL_OBJECT_UPDATE, "MapUpdate.ParallelObjectUpdate", false);
+    setConfig(CONFIG_BOOL_MAP_PIPELINED_WORLD_UPDATE, "MapUpdate.PipelinedWorldUpdate", false);
+    setConfig(CONFIG_UINT32_MAP_PARALLEL_OBJECT_UPDATE_MIN_OBJECTS, "MapUpdate.ParallelObjectUpdate.MinObjects", 1000);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -886,6 +894,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfig(CONFIG_UINT32_COLLISION_CACHE_SIZE, "vmap.collisionCacheSize", 1024);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
 
@@ -1638,18 +1647,15 @@ void World::Update(uint32 diff)
     if (m_gameTime > m_NextRandomBattlegroundReset)
         ResetRandomBattleground();
 
+    // in pipelined mode global work which does not touch map objects runs while the map update threads are busy
+    bool const pipelined = getConfig(CONFIG_BOOL_MAP_PIPELINED_WORLD_UPDATE) && sMapMgr.GetUpdater().activated();
+
     /// <ul><li> Handle auctions when the timer has passed
-    if (m_timers[WUPDATE_AUCTIONS].Passed())
+    if (!pipelined && m_timers[WUPDATE_AUCTIONS].Passed())
     {
         m_timers[WUPDATE_AUCTIONS].Reset();
 
-        ///- Update mails (return old mails with item, or delete them)
-        //(tested... works on win)
-        if (++mail_timer > mail_timer_expires)
-        {
-            mail_timer = 0;
-            sObjectMgr.ReturnOrDeleteOldMails(true);
-        }
+        _UpdateOldMails();
 
         ///- Handle expired auctions
         sAuctionMgr.Update();
@@ -1685,13 +1691,57 @@ void World::Update(uint32 diff)
 #ifdef BUILD_METRICS
     auto preMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
-    sMapMgr.Update(diff);
+    if (pipelined)
+    {
+        sMapMgr.ScheduleUpdate(diff);
+
+        bool auctionsCollected = false;
+        if (m_timers[WUPDATE_AUCTIONS].Passed())
+        {
+            m_timers[WUPDATE_AUCTIONS].Reset();
+
+            _UpdateOldMails();
+
+            ///- Only find expired auctions here, their mails can reach online players
+            sAuctionMgr.CollectFinishedAuctions();
+            auctionsCollected = true;
+        }
+
+        ///- Raid browser listings are only changed by world thread messages, build their results here
+        bool raidBrowserUpdated = false;
+        if (m_timers[WUPDATE_RAID_BROWSER].Passed())
+        {
+            m_timers[WUPDATE_RAID_BROWSER].Reset();
+            GetRaidBrowser().Update(this);
+            raidBrowserUpdated = true;
+        }
+
+#ifdef BUILD_METRICS
+        if (m_timers[WUPDATE_METRICS].Passed())
+        {
+            m_timers[WUPDATE_METRICS].Reset();
+            GeneratePacketMetrics();
+        }
+#endif
+
+        ///- Sync point, everything below may touch map objects again
+        sMapMgr.FinishUpdate();
+
+        if (auctionsCollected)
+            sAuctionMgr.Update();
+
+        if (raidBrowserUpdated)
+            GetRaidBrowser().SendSearchResults();
+    }
+    else
+        sMapMgr.Update(diff);
 #ifdef BUILD_METRICS
     auto postMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
     sBattleGroundMgr.Update(diff);
     sOutdoorPvPMgr.Update(diff);
     sWorldState.Update(diff);
+    sSocialMgr.SendQueuedFriendStatus();
 #ifdef BUILD_METRICS
     auto postSingletonTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
@@ -1734,10 +1784,11 @@ void World::Update(uint32 diff)
     }
 
     //- Process Raid browser
-    if (m_timers[WUPDATE_RAID_BROWSER].Passed())
+    if (!pipelined && m_timers[WUPDATE_RAID_BROWSER].Passed())
     {
         m_timers[WUPDATE_RAID_BROWSER].Reset();
         GetRaidBrowser().Update(this);
+        GetRaidBrowser().SendSearchResults();
     }
 
 #ifdef BUILD_METRICS
@@ -2228,6 +2279,17 @@ void World::ShutdownCancel()
     DEBUG_LOG("Server %s cancelled.", (m_ShutdownMask & SHUTDOWN_MASK_RESTART ? "restart" : "shutdown"));
 }
 
+void World::_UpdateOldMails()
+{
+    ///- Update mails (return old mails with item, or delete them)
+    //(tested... works on win)
+    if (++mail_timer > mail_timer_expires)
+    {
+        mail_timer = 0;
+        sObjectMgr.ReturnOrDeleteOldMails(true);
+    }
+}
+
 void World::UpdateSessions(uint32 diff)
 {
     ///- Add new sessions
@@ -2866,8 +2928,40 @@ void World::GeneratePacketMetrics()
     meas_players.add_field("druid", std::to_string(GetOnlineClassPlayers(CLASS_DRUID)));
     meas_players.add_field("deathknight", std::to_string(GetOnlineClassPlayers(CLASS_DEATH_KNIGHT)));
 
+    uint32 packetsAllocated = 0;
+    uint32 packetsReused = 0;
+    ExecuteForAllSessions([&](WorldSession& session)
+    {
+        uint32 allocated, reused;
+        session.ResetPacketPoolCounters(allocated, reused);
+        packetsAllocated += allocated;
+        packetsReused += reused;
+    });
+    metric::measurement meas_packet_pool("world.metrics.packets.pool");
+    meas_packet_pool.add_field("allocated", std::to_string(packetsAllocated));
+    meas_packet_pool.add_field("reused", std::to_string(packetsReused));
+
     metric::measurement meas_latency("world.metrics.latency");
     meas_latency.add_field("online", std::to_string(GetAverageLatency()));
+
+    metric::measurement meas_db("world.metrics.db.async");
+    meas_db.add_field("character_queue", std::to_string(CharacterDatabase.GetAsyncQueueSize()));
+    meas_db.add_field("character_max_latency", std::to_string(CharacterDatabase.ResetAsyncMaxLatency()));
+    meas_db.add_field("login_queue", std::to_string(LoginDatabase.GetAsyncQueueSize()));
+    meas_db.add_field("login_max_latency", std::to_string(LoginDatabase.ResetAsyncMaxLatency()));
+    meas_db.add_field("world_queue", std::to_string(WorldDatabase.GetAsyncQueueSize()));
+    meas_db.add_field("world_max_latency", std::to_string(WorldDatabase.ResetAsyncMaxLatency()));
+
+    metric::measurement meas_messager("world.metrics.messager");
+    meas_messager.add_field("world_collisions", std::to_string(m_messager.ResetCollisionCount()));
+    meas_messager.add_field("lfg_collisions", std::to_string(GetLFGQueue().GetMessager().ResetCollisionCount()));
+
+    uint32 preloadHits, preloadLate, preloadMisses;
+    sMapMgr.GetGridPreloader().ResetCounters(preloadHits, preloadLate, preloadMisses);
+    metric::measurement meas_preload("world.metrics.grid_preload");
+    meas_preload.add_field("hits", std::to_string(preloadHits));
+    meas_preload.add_field("late", std::to_string(preloadLate));
+    meas_preload.add_field("misses", std::to_string(preloadMisses));
 }
 
 uint32 World::GetAverageLatency() const
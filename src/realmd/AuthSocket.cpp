@@ -29,6 +29,8 @@
 #include "RealmList.h"
 #include "AuthSocket.h"
 #include "AuthCodes.h"
+#include "AuthWorkerPool.h"
+#include "IpBanList.h"
 #include "Auth/SRP6.h"
 #include "Util/CommonDefines.h"
 
@@ -179,7 +181,7 @@ std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B,
 
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
+    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountId(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
 {
 }
 
@@ -232,7 +234,7 @@ bool AuthSocket::ProcessIncomingData()
                 continue;
 
             // unauthorized
-            DEBUG_LOG("[Auth] Status %u, table status %u", _status, table[i].status);
+            DEBUG_LOG("[Auth] Status %u, table status %u", uint32(_status), table[i].status);
 
             if (table[i].status != _status)
             {
@@ -348,8 +350,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -376,24 +376,35 @@ bool AuthSocket::_HandleLogonChallenge()
     LoginDatabase.escape_string(_safelocale);
     LoginDatabase.escape_string(m_os);
 
+    ///- Ban and account lookups block on the database, answer from an auth worker
+    _status = STATUS_WAITING;
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    sAuthWorkerPool.Enqueue([self]() { self->_ProcessLogonChallenge(); });
+    return true;
+}
+
+void AuthSocket::_ProcessLogonChallenge()
+{
+    ///- Session is closed unless overriden
+    _status = STATUS_CLOSED;
+
+    ByteBuffer pkt;
     pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
     pkt << uint8(0x00);
 
     ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > " _UNIXTIME_ ") AND ip = '%s'", m_address.c_str()));
-
-    if (ip_banned_result)
+    if (sIpBanList.IsBanned(m_address))
     {
         pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
         BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
     }
     else
     {
-        ///- Get the account details from the account table
+        ///- Get the account details from the account table, along with its active ban if any
         // No SQL injection (escaped user name)
-        auto queryResult = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
+        auto queryResult = LoginDatabase.PQuery("SELECT a.id,a.locked,a.lockedIp,a.gmlevel,a.v,a.s,a.token,b.banned_at,b.expires_at FROM account a "
+                                                "LEFT JOIN account_banned b ON b.account_id = a.id AND b.active = 1 AND (b.expires_at > " _UNIXTIME_ " OR b.expires_at = b.banned_at) "
+                                                "WHERE a.username = '%s'", _safelogin.c_str());
         if (queryResult)
         {
             Field* fields = queryResult->Fetch();
@@ -430,11 +441,9 @@ bool AuthSocket::_HandleLogonChallenge()
             if (!locked && !broken)
             {
                 ///- If the account is banned, reject the logon attempt
-                auto banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > " _UNIXTIME_ " OR expires_at = banned_at)", fields[0].GetUInt32());
-                if (banresult)
+                if (!fields[7].IsNULL())
                 {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
+                    if (fields[7].GetUInt64() == fields[8].GetUInt64())
                     {
                         pkt << uint8(AUTH_LOGON_FAILED_BANNED);
                         BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
@@ -492,6 +501,7 @@ bool AuthSocket::_HandleLogonChallenge()
                     if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
                         pkt << uint8(1);
 
+                    _accountId = fields[0].GetUInt32();
                     uint8 secLevel = fields[3].GetUInt8();
                     _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
 
@@ -505,7 +515,6 @@ bool AuthSocket::_HandleLogonChallenge()
     }
 
     Write((const char*)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Logon Proof command handler
@@ -535,11 +544,36 @@ bool AuthSocket::_HandleLogonProof()
     }
     /// </ul>
 
+    ///- The authenticator pin trails the proof, take it from the buffer before handing the proof to a worker
+    bool pinReceived = false;
+    std::string pin;
+    if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
+    {
+        uint8 pinCount;
+        if (Read((char*)&pinCount, sizeof(uint8)))
+        {
+            pin.resize(pinCount);
+            pinReceived = Read((char*)&pin[0], sizeof(uint8) * pinCount);
+        }
+    }
+
+    _status = STATUS_WAITING;
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    sAuthWorkerPool.Enqueue([self, lp, pinReceived, pin]() { self->_ProcessLogonProof(lp, pinReceived, pin); });
+    return true;
+}
+
+void AuthSocket::_ProcessLogonProof(sAuthLogonProof_C lp, bool pinReceived, std::string const& pin)
+{
+    ///- Session is closed unless overriden
+    _status = STATUS_CLOSED;
+
     ///- Continue the SRP6 calculation based on data received from the client
-    if(!srp.CalculateSessionKey(lp.A, 32))
+    if (!srp.CalculateSessionKey(lp.A, 32))
     {
         BASIC_LOG("[AuthChallenge] Session calculation failed for account %s!", _login.c_str());
-        return false;
+        Close();
+        return;
     }
 
     srp.HashSessionKey();
@@ -550,31 +584,22 @@ bool AuthSocket::_HandleLogonProof()
     {
         if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
         {
-            uint8 pinCount;
-            if (!Read((char*)&pinCount, sizeof(uint8)))
-            {
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
-                Write(data, sizeof(data));
-                return true;
-            }
-            std::vector<uint8> keys(pinCount + 1);
-            if (!Read((char*)keys.data(), sizeof(uint8) * pinCount))
+            if (!pinReceived)
             {
                 const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
                 Write(data, sizeof(data));
-                return true;
+                return;
             }
 
-            keys[pinCount] = '\0';
             auto ServerToken = generateToken(_token.c_str());
-            auto clientToken = atoi((const char*)keys.data());
+            auto clientToken = atoi(pin.c_str());
             if (ServerToken != clientToken)
             {
-                BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u Pin Count: %u", _login.c_str(), clientToken, ServerToken, pinCount);
+                BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u Pin Count: %u", _login.c_str(), clientToken, ServerToken, uint32(pin.size()));
 
                 const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
                 Write(data, sizeof(data));
-                return true;
+                return;
             }
         }
 
@@ -584,7 +609,7 @@ bool AuthSocket::_HandleLogonProof()
 
             const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_VERSION_INVALID };
             Write(data, sizeof(data));
-            return true;
+            return;
         }
 
         BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
@@ -593,19 +618,17 @@ bool AuthSocket::_HandleLogonProof()
         // No SQL injection (escaped user input) and IP address as received by socket
         const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
         LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", K_hex, _safelocale.c_str(), m_os.c_str(), m_platform.c_str(), _safelogin.c_str());
-        std::unique_ptr<QueryResult> loginfail(LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()));
-        if (loginfail)
-            LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s'," _NOW_ ",'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
+        LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s'," _NOW_ ",'%u')", _accountId, m_address.c_str(), LOGIN_TYPE_REALMD);
         OPENSSL_free((void*)K_hex);
 
         ///- Finish SRP6 and send the final result to the client
         Sha1Hash sha;
         srp.Finalize(sha);
 
-        SendProof(sha);
-
         ///- Set _status to authed!
         _status = STATUS_AUTHED;
+
+        SendProof(sha);
     }
     else
     {
@@ -629,10 +652,10 @@ bool AuthSocket::_HandleLogonProof()
             // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
             LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
 
-            if (auto loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
+            if (auto loginfail = LoginDatabase.PQuery("SELECT failed_logins FROM account WHERE id = '%u'", _accountId))
             {
                 Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
+                uint32 failed_logins = fields[0].GetUInt32();
 
                 if (failed_logins >= MaxWrongPassCount)
                 {
@@ -641,10 +664,9 @@ bool AuthSocket::_HandleLogonProof()
 
                     if (WrongPassBanType)
                     {
-                        uint32 acc_id = fields[0].GetUInt32();
                         LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
                                                "VALUES ('%u'," _UNIXTIME_ "," _UNIXTIME_ "+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
+                                               _accountId, WrongPassBanTime);
                         BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
                                   _login.c_str(), WrongPassBanTime, failed_logins);
                     }
@@ -654,6 +676,7 @@ bool AuthSocket::_HandleLogonProof()
                         LoginDatabase.escape_string(current_ip);
                         LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s'," _UNIXTIME_ "," _UNIXTIME_ "+'%u','MaNGOS realmd','Failed login autoban')",
                                                current_ip.c_str(), WrongPassBanTime);
+                        sIpBanList.AddBan(m_address, WrongPassBanTime);
                         BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
                                   current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
                     }
@@ -661,7 +684,6 @@ bool AuthSocket::_HandleLogonProof()
             }
         }
     }
-    return true;
 }
 
 /// Reconnect Challenge command handler
@@ -707,18 +729,32 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    auto queryResult = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
+    _status = STATUS_WAITING;
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    sAuthWorkerPool.Enqueue([self]() { self->_ProcessReconnectChallenge(); });
+    return true;
+}
+
+void AuthSocket::_ProcessReconnectChallenge()
+{
+    ///- Session is closed unless overriden
+    _status = STATUS_CLOSED;
+
+    auto queryResult = LoginDatabase.PQuery("SELECT id, gmlevel, sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
 
     // Stop if the account is not found
     if (!queryResult)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
         Close();
-        return false;
+        return;
     }
 
     Field* fields = queryResult->Fetch();
-    srp.SetStrongSessionKey(fields[0].GetString());
+    _accountId = fields[0].GetUInt32();
+    uint8 secLevel = fields[1].GetUInt8();
+    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+    srp.SetStrongSessionKey(fields[2].GetString());
 
     ///- All good, await client's proof
     _status = STATUS_RECON_PROOF;
@@ -731,7 +767,6 @@ bool AuthSocket::_HandleReconnectChallenge()
     pkt.append(_reconnectProof.AsByteArray(16));        // 16 bytes random
     pkt.append(VersionChallenge.data(), VersionChallenge.size());
     Write((const char*)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Reconnect Proof command handler
@@ -795,38 +830,49 @@ bool AuthSocket::_HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
-
-    auto queryResult = LoginDatabase.PQuery("SELECT id, gmlevel FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!queryResult)
-    {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
-        Close();
-        return false;
-    }
-
-    uint32 id = (*queryResult)[0].GetUInt32();
-    uint8 accountSecurityLevel = (*queryResult)[1].GetUInt8();
+    _status = STATUS_WAITING;
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    sAuthWorkerPool.Enqueue([self]() { self->_ProcessRealmList(); });
+    return true;
+}
 
+void AuthSocket::_ProcessRealmList()
+{
     ///- Update realm list if need
     sRealmList.UpdateIfNeed();
 
     ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
+    // account id and security level were stored by the (reconnect) challenge
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id, accountSecurityLevel);
+    LoadRealmlist(pkt, _accountId, _accountSecurityLevel);
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
     hdr << (uint16)pkt.size();
     hdr.append(pkt);
 
+    _status = STATUS_AUTHED;
+
     Write((const char*)hdr.contents(), hdr.size());
-    return true;
 }
 
 void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLevel)
 {
+    RealmList::RealmMapPtr realms = sRealmList.GetRealms();
+
+    ///- Get the character count of all realms at once
+    // No SQL injection. account id is controlled by the database.
+    std::map<uint32, uint8> charactersPerRealm;
+    if (auto queryResult = LoginDatabase.PQuery("SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", acctid))
+    {
+        do
+        {
+            Field* fields = queryResult->Fetch();
+            charactersPerRealm[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        }
+        while (queryResult->NextRow());
+    }
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -834,21 +880,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
         case 6141:                                          // 1.12.3
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint8(getEligibleRealmCount(securityLevel));
+            pkt << uint8(getEligibleRealmCount(*realms, securityLevel));
 
-            for (const auto& i : sRealmList)
+            for (const auto& i : *realms)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                auto queryResult = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (queryResult)
-                {
-                    Field* fields = queryResult->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto chars = charactersPerRealm.find(i.second.m_ID);
+                uint8 AmountOfCharacters = chars != charactersPerRealm.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -898,21 +935,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
         default:                                            // and later
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint16(getEligibleRealmCount(securityLevel));
+            pkt << uint16(getEligibleRealmCount(*realms, securityLevel));
 
-            for (const auto& i : sRealmList)
+            for (const auto& i : *realms)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                auto queryResult = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (queryResult)
-                {
-                    Field* fields = queryResult->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto chars = charactersPerRealm.find(i.second.m_ID);
+                uint8 AmountOfCharacters = chars != charactersPerRealm.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -960,10 +988,10 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
     }
 }
 
-uint8 AuthSocket::getEligibleRealmCount(uint8 accountSecurityLevel)
+uint8 AuthSocket::getEligibleRealmCount(RealmList::RealmMap const& realms, uint8 accountSecurityLevel)
 {
     uint8 size = 0;
-    for (const auto& i : sRealmList)
+    for (const auto& i : realms)
         if (i.second.allowedSecurityLevel <= accountSecurityLevel)
             size++;
 
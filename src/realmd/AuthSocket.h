@@ -28,15 +28,19 @@
 #include "Auth/CryptoHash.h"
 #include "Auth/SRP6.h"
 #include "Util/ByteBuffer.h"
+#include "RealmList.h"
 
 #include "Network/Socket.hpp"
 
 #include <boost/asio.hpp>
 
+#include <atomic>
 #include <functional>
 
 #define HMAC_RES_SIZE 20
 
+struct AUTH_LOGON_PROOF_C;
+
 class AuthSocket : public MaNGOS::Socket
 {
     public:
@@ -50,7 +54,7 @@ class AuthSocket : public MaNGOS::Socket
         void LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 accountSecurityLevel = 0);
         int32 generateToken(char const* b32key);
 
-        uint8 getEligibleRealmCount(uint8 accountSecurityLevel);
+        uint8 getEligibleRealmCount(RealmList::RealmMap const& realms, uint8 accountSecurityLevel);
 
         bool VerifyVersion(uint8 const* a, int32 aLength, uint8 const* versionProof, bool isReconnect);
         bool _HandleLogonChallenge();
@@ -72,13 +76,20 @@ class AuthSocket : public MaNGOS::Socket
             STATUS_RECON_PROOF,
             STATUS_PATCH,      // unused in CMaNGOS
             STATUS_AUTHED,
-            STATUS_CLOSED
+            STATUS_CLOSED,
+            STATUS_WAITING     // request handed to an auth worker, no further command accepted until it answers
         };
 
+        // second halves of the handlers above, run on an auth worker thread
+        void _ProcessLogonChallenge();
+        void _ProcessLogonProof(AUTH_LOGON_PROOF_C lp, bool pinReceived, std::string const& pin);
+        void _ProcessReconnectChallenge();
+        void _ProcessRealmList();
+
         SRP6 srp;
         BigNumber _reconnectProof;
 
-        eStatus _status;
+        std::atomic<eStatus> _status;
 
         std::string _login;
         std::string _safelogin;
@@ -88,6 +99,7 @@ class AuthSocket : public MaNGOS::Socket
         std::string m_locale;
         std::string _safelocale;
         uint16 _build;
+        uint32 _accountId;
         AccountTypes _accountSecurityLevel;
 
         boost::asio::deadline_timer m_timeoutTimer;
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+#include "Database/DatabaseEnv.h"
+#include "Log/Log.h"
+
+extern DatabaseType LoginDatabase;
+
+AuthWorkerPool& AuthWorkerPool::Instance()
+{
+    static AuthWorkerPool pool;
+    return pool;
+}
+
+void AuthWorkerPool::Start(uint32 threadCount)
+{
+    for (uint32 i = 0; i < threadCount; ++i)
+        m_workers.emplace_back(&AuthWorkerPool::WorkerThread, this);
+
+    sLog.outString("Started %u auth worker thread(s)", threadCount);
+}
+
+void AuthWorkerPool::Stop()
+{
+    m_stopping = true;
+    m_tasks.Cancel();
+
+    // the workers are kept in the vector, sockets still open keep queueing into the cancelled queue
+    for (auto& worker : m_workers)
+        if (worker.joinable())
+            worker.join();
+}
+
+void AuthWorkerPool::Enqueue(Task&& task)
+{
+    if (m_workers.empty())
+    {
+        task();
+        return;
+    }
+
+    m_tasks.Push(std::move(task));
+}
+
+void AuthWorkerPool::WorkerThread()
+{
+    LoginDatabase.ThreadStart();
+
+    while (!m_stopping)
+    {
+        Task task;
+        m_tasks.WaitAndPop(task);
+
+        if (task)
+            task();
+    }
+
+    LoginDatabase.ThreadEnd();
+}
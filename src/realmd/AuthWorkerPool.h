@@ -0,0 +1,63 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+#include "Util/ProducerConsumerQueue.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/// Runs the blocking parts of the auth handshake (database lookups, SRP6 math) off the network threads
+class AuthWorkerPool
+{
+    public:
+        typedef std::function<void()> Task;
+
+        static AuthWorkerPool& Instance();
+
+        AuthWorkerPool() : m_stopping(false) {}
+        ~AuthWorkerPool() { Stop(); }
+
+        void Start(uint32 threadCount);
+        void Stop();
+
+        /// Queue a task, executed inline when no worker thread was started
+        void Enqueue(Task&& task);
+
+        uint32 GetThreadCount() const { return m_workers.size(); }
+    private:
+        void WorkerThread();
+
+        ProducerConsumerQueue<Task> m_tasks;
+        std::vector<std::thread> m_workers;
+        std::atomic<bool> m_stopping;
+};
+
+#define sAuthWorkerPool AuthWorkerPool::Instance()
+
+#endif
+/// @}
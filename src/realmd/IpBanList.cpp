@@ -0,0 +1,118 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "IpBanList.h"
+#include "Database/DatabaseEnv.h"
+#include "Log/Log.h"
+
+extern DatabaseType LoginDatabase;
+
+IpBanList::IpBanList() : m_UpdateInterval(0), m_NextUpdateTime(0)
+{
+}
+
+IpBanList& IpBanList::Instance()
+{
+    static IpBanList banlist;
+    return banlist;
+}
+
+void IpBanList::Initialize(uint32 updateInterval)
+{
+    m_UpdateInterval = updateInterval;
+
+    if (m_UpdateInterval)
+        UpdateIfNeed();
+}
+
+void IpBanList::UpdateIfNeed()
+{
+    // maybe disabled or updated recently
+    if (!m_UpdateInterval || m_NextUpdateTime > time(nullptr))
+        return;
+
+    m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
+
+    LoadBans();
+}
+
+void IpBanList::LoadBans()
+{
+    ////                                                  0   1          2
+    auto queryResult = LoginDatabase.Query("SELECT ip, banned_at, expires_at FROM ip_banned WHERE expires_at = banned_at OR expires_at > " _UNIXTIME_);
+
+    BanMap bans;
+    if (queryResult)
+    {
+        do
+        {
+            Field* fields = queryResult->Fetch();
+
+            uint64 bannedAt = fields[1].GetUInt64();
+            uint64 expiresAt = fields[2].GetUInt64();
+            time_t expires = expiresAt == bannedAt ? 0 : time_t(expiresAt);
+
+            // the same address may be banned several times, keep the longest ban
+            auto itr = bans.find(fields[0].GetCppString());
+            if (itr == bans.end())
+                bans.emplace(fields[0].GetCppString(), expires);
+            else if (itr->second && (!expires || expires > itr->second))
+                itr->second = expires;
+        }
+        while (queryResult->NextRow());
+    }
+
+    DETAIL_LOG("Loaded %u active ip bans", uint32(bans.size()));
+
+    std::lock_guard<std::mutex> guard(m_bansLock);
+    m_bans.swap(bans);
+}
+
+bool IpBanList::IsBanned(std::string const& ip) const
+{
+    if (!m_UpdateInterval)
+    {
+        // No SQL injection possible (paste the IP address as passed by the socket)
+        std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
+                "WHERE (expires_at = banned_at OR expires_at > " _UNIXTIME_ ") AND ip = '%s'", ip.c_str()));
+        return !!ip_banned_result;
+    }
+
+    std::lock_guard<std::mutex> guard(m_bansLock);
+    auto itr = m_bans.find(ip);
+    return itr != m_bans.end() && (!itr->second || itr->second > time(nullptr));
+}
+
+void IpBanList::AddBan(std::string const& ip, uint32 duration)
+{
+    if (!m_UpdateInterval)
+        return;
+
+    time_t expires = duration ? time(nullptr) + duration : 0;
+
+    std::lock_guard<std::mutex> guard(m_bansLock);
+    auto itr = m_bans.find(ip);
+    if (itr == m_bans.end())
+        m_bans.emplace(ip, expires);
+    else if (itr->second && (!expires || expires > itr->second))
+        itr->second = expires;
+}
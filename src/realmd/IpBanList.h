@@ -0,0 +1,62 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _IPBANLIST_H
+#define _IPBANLIST_H
+
+#include "Common.h"
+
+#include <mutex>
+#include <unordered_map>
+
+/// In-memory copy of the ip_banned table, refreshed periodically instead of queried at every logon challenge
+class IpBanList
+{
+    public:
+        static IpBanList& Instance();
+
+        IpBanList();
+        ~IpBanList() {}
+
+        void Initialize(uint32 updateInterval);
+
+        void UpdateIfNeed();
+
+        bool IsBanned(std::string const& ip) const;
+
+        /// Record a ban realmd just wrote to the database, so it is effective before the next refresh
+        void AddBan(std::string const& ip, uint32 duration);
+    private:
+        void LoadBans();
+    private:
+        typedef std::unordered_map<std::string, time_t> BanMap;    ///< ip -> expiration time, 0 for permanent bans
+
+        BanMap m_bans;
+        mutable std::mutex m_bansLock;
+        uint32 m_UpdateInterval;                            ///< 0 disables the cache, every check then goes to the database
+        time_t m_NextUpdateTime;
+};
+
+#define sIpBanList IpBanList::Instance()
+
+#endif
+/// @}
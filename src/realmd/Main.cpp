@@ -27,6 +27,8 @@
 #include "Config/Config.h"
 #include "Log/Log.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
+#include "IpBanList.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_sql.h"
@@ -231,6 +233,10 @@ int main(int argc, char* argv[])
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE expires_at<=" _UNIXTIME_ " AND expires_at<>banned_at");
     LoginDatabase.CommitTransaction();
 
+    sIpBanList.Initialize(sConfig.GetIntDefault("IpBanListUpdateDelay", 10));
+
+    sAuthWorkerPool.Start(std::max(0, sConfig.GetIntDefault("AuthWorkerThreads", 2)));
+
     // FIXME - more intelligent selection of thread count is needed here.  config option?
     MaNGOS::Listener<AuthSocket> listener(
             sConfig.GetStringDefault("BindIP", "0.0.0.0"),
@@ -303,6 +309,7 @@ int main(int argc, char* argv[])
             DETAIL_LOG("Ping MySQL to keep connection alive");
             LoginDatabase.Ping();
         }
+        sIpBanList.UpdateIfNeed();
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
 #ifdef _WIN32
         if (m_ServiceStatus == 0) stopEvent = true;
@@ -310,6 +317,8 @@ int main(int argc, char* argv[])
 #endif
     }
 
+    sAuthWorkerPool.Stop();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -350,9 +359,12 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    // every auth worker thread runs its queries on its own connection
+    int nConns = std::max(1, sConfig.GetIntDefault("AuthWorkerThreads", 2));
+
+    sLog.outString("Login Database total connections: %i", nConns + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConns))
     {
         sLog.outError("Cannot connect to database");
         return false;
@@ -81,7 +81,7 @@ RealmBuildInfo const* FindBuildInfo(uint16 _build)
     return nullptr;
 }
 
-RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(nullptr))
+RealmList::RealmList() : m_realms(std::make_shared<RealmMap>()), m_UpdateInterval(0), m_NextUpdateTime(time(nullptr))
 {
 }
 
@@ -100,10 +100,16 @@ void RealmList::Initialize(uint32 updateInterval)
     UpdateRealms(true);
 }
 
-void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
+RealmList::RealmMapPtr RealmList::GetRealms() const
+{
+    std::lock_guard<std::mutex> guard(m_realmsLock);
+    return m_realms;
+}
+
+void RealmList::UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
 {
     ///- Create new if not exist or update existed
-    Realm& realm = m_realms[name];
+    Realm& realm = realms[name];
 
     realm.m_ID       = ID;
     realm.icon       = icon;
@@ -141,14 +147,16 @@ void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::strin
 
 void RealmList::UpdateIfNeed()
 {
-    // maybe disabled or updated recently
-    if (!m_UpdateInterval || m_NextUpdateTime > time(nullptr))
+    // maybe disabled
+    if (!m_UpdateInterval)
         return;
 
-    m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
+    // another worker is already refreshing, keep serving the current snapshot
+    std::unique_lock<std::mutex> updateGuard(m_updateLock, std::try_to_lock);
+    if (!updateGuard.owns_lock() || m_NextUpdateTime > time(nullptr))
+        return;
 
-    // Clears Realm list
-    m_realms.clear();
+    m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
 
     // Get the content of the realmlist table in the database
     UpdateRealms(false);
@@ -161,6 +169,9 @@ void RealmList::UpdateRealms(bool init)
     ////                                           0   1     2        3     4     5           6         7                     8           9
     auto queryResult = LoginDatabase.Query("SELECT id, name, address, port, icon, realmflags, timezone, allowedSecurityLevel, population, realmbuilds FROM realmlist WHERE (realmflags & 1) = 0 ORDER BY name");
 
+    ///- Build a fresh map outside the lock so readers never see a partially filled list
+    auto realms = std::make_shared<RealmMap>();
+
     ///- Circle through results and add them to the realm map
     if (queryResult)
     {
@@ -179,7 +190,7 @@ void RealmList::UpdateRealms(bool init)
                 realmflags &= (REALM_FLAG_OFFLINE | REALM_FLAG_NEW_PLAYERS | REALM_FLAG_RECOMMENDED | REALM_FLAG_SPECIFYBUILD);
             }
 
-            UpdateRealm(
+            UpdateRealm(*realms,
                 Id, name, fields[2].GetCppString(), fields[3].GetUInt32(),
                 fields[4].GetUInt8(), RealmFlags(realmflags), fields[6].GetUInt8(),
                 (allowedSecurityLevel <= SEC_ADMINISTRATOR ? AccountTypes(allowedSecurityLevel) : SEC_ADMINISTRATOR),
@@ -190,4 +201,7 @@ void RealmList::UpdateRealms(bool init)
         }
         while (queryResult->NextRow());
     }
+
+    std::lock_guard<std::mutex> guard(m_realmsLock);
+    m_realms = std::move(realms);
 }
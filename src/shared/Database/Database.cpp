@@ -91,13 +91,16 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     return pStmt->execute();
 }
 
+//////////////////////////////////////////////////////////////////////////
+thread_local uint32 SqlOrderingKey::m_currentKey = 0;
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -134,10 +137,29 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // setup async worker count
+#ifdef DO_SQLITE
+    // sqlite locks the whole database file for writing, parallel writers would only fail with SQLITE_BUSY
+    nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+#endif
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    // create and initialize connections for async requests
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConnections.push_back(pConn);
+    }
+    m_pAsyncConn = m_pAsyncConnections.front();
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -150,10 +172,12 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
+    for (auto& asyncConn : m_pAsyncConnections)
+        delete asyncConn;
 
     m_pResultQueue = nullptr;
     m_pAsyncConn = nullptr;
+    m_pAsyncConnections.clear();
 
     for (auto& m_pQueryConnection : m_pQueryConnections)
         delete m_pQueryConnection;
@@ -161,30 +185,50 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    // only the first worker pings the whole pool, the others keep their own connection alive
+    return new SqlDelayThread(this, conn, conn == m_pAsyncConn);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    // New delay thread for delay execute, one per async connection
+    for (auto& asyncConn : m_pAsyncConnections)
+    {
+        SqlDelayThread* threadBody = CreateDelayThread(asyncConn);  // will deleted at thread delete
+        m_threadBodies.push_back(threadBody);
+        m_delayThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
+
+    std::lock_guard<std::mutex> guard(m_barrierMutex);
+    m_barriersEnabled = m_threadBodies.size() > 1;
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (m_threadBodies.empty() || m_delayThreads.empty()) return;
+
+    // workers leave one by one, a barrier queued from now on could wait for an already stopped worker
+    {
+        std::lock_guard<std::mutex> guard(m_barrierMutex);
+        m_barriersEnabled = false;
+    }
+
+    for (auto& threadBody : m_threadBodies)
+        threadBody->Stop();                                 // Stop event
+
+    for (auto& delayThread : m_delayThreads)
+    {
+        delayThread->wait();                                // Wait for flush to DB
+        delete delayThread;                                 // This also deletes the thread body
+    }
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = nullptr;
-    m_threadBody = nullptr;
+    m_delayThreads.clear();
+    m_threadBodies.clear();
 }
 
 void Database::ThreadStart()
@@ -229,8 +273,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (auto& asyncConn : m_pAsyncConnections)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(asyncConn);
         guard->Query(sql);
     }
 
@@ -241,6 +286,41 @@ void Database::Ping()
     }
 }
 
+bool Database::DelayOperation(SqlOperation* sql)
+{
+    if (SqlOrderingKey::GetCurrent() != 0)
+        return GetDelayThread()->Delay(sql);
+
+    std::lock_guard<std::mutex> guard(m_barrierMutex);
+    if (!m_barriersEnabled)
+        return GetDelayThread()->Delay(sql);
+
+    // every worker reaches the barrier before the request runs on the first one and waits for its end
+    auto barrier = std::make_shared<SqlBarrier>(uint32(m_threadBodies.size() - 1));
+    for (size_t i = 1; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->Delay(new SqlBarrierWait(barrier));
+
+    return m_threadBodies[0]->Delay(new SqlBarrierRequest(barrier, sql));
+}
+
+uint32 Database::GetAsyncQueueSize() const
+{
+    uint32 queueSize = 0;
+    for (auto threadBody : m_threadBodies)
+        queueSize += threadBody->GetQueueSize();
+
+    return queueSize;
+}
+
+uint32 Database::ResetAsyncMaxLatency()
+{
+    uint32 maxLatency = 0;
+    for (auto threadBody : m_threadBodies)
+        maxLatency = std::max(maxLatency, threadBody->ResetMaxLatency());
+
+    return maxLatency;
+}
+
 bool Database::PExecuteLog(const char* format, ...)
 {
     if (!format)
@@ -340,7 +420,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        DelayOperation(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -409,7 +489,7 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_currentTransaction.release());
+    DelayOperation(m_currentTransaction.release());
     return true;
 }
 
@@ -563,7 +643,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        DelayOperation(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -101,15 +101,36 @@ class SqlConnection
         StmtHolder m_holder;
 };
 
+// Selects the async worker for requests issued by the current thread while the object lives.
+// Async requests with the same key are executed in order, requests with different keys may run in parallel.
+// Requests issued without a key use key 0, the shared key: they are ordered against the requests of every key,
+// so rows shared between accounts (guilds, mail, auctions, trades...) must be written under key 0.
+class SqlOrderingKey
+{
+    public:
+        explicit SqlOrderingKey(uint32 key) : m_prevKey(m_currentKey) { m_currentKey = key; }
+        ~SqlOrderingKey() { m_currentKey = m_prevKey; }
+
+        SqlOrderingKey(SqlOrderingKey const&) = delete;
+        SqlOrderingKey& operator=(SqlOrderingKey const&) = delete;
+
+        static uint32 GetCurrent() { return m_currentKey; }
+
+    private:
+        uint32 const m_prevKey;
+
+        static thread_local uint32 m_currentKey;
+};
+
 class Database
 {
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
-        // start worker thread for async DB request execution
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
+        // start worker threads for async DB request execution
         virtual void InitDelayThread();
-        // stop worker thread
+        // stop worker threads
         virtual void HaltDelayThread();
 
         /// Synchronous DB queries
@@ -217,6 +238,11 @@ class Database
         // function to ping database connections
         void Ping();
 
+        // async worker statistics
+        uint32 GetAsyncQueueSize() const;
+        // longest async request latency in ms since the previous call
+        uint32 ResetAsyncMaxLatency();
+
         // set this to allow async transactions
         // you should call it explicitly after your server successfully started up
         // NO ASYNC TRANSACTIONS DURING SERVER STARTUP - ONLY DURING RUNTIME!!!
@@ -225,7 +251,7 @@ class Database
     protected:
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_allowAsyncTransactions(false),
+            m_barriersEnabled(false), m_allowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -236,7 +262,7 @@ class Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn);
 
         // per-thread based storage for SqlTransaction object initialization - no locking is required
         boost::thread_specific_ptr<SqlTransaction> m_currentTransaction;
@@ -245,10 +271,15 @@ class Database
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
+        // connection used for direct execution, shared with the first async worker
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        // async worker owning the ordering key of the current thread
+        SqlDelayThread* GetDelayThread() const { return m_threadBodies[SqlOrderingKey::GetCurrent() % m_threadBodies.size()]; }
+        // queue an async request for the ordering key of the current thread, shared key requests become barriers
+        bool DelayOperation(SqlOperation* sql);
 
         friend class SqlStatement;
+        friend class SqlQueryHolder;
         // PREPARED STATEMENT API
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
@@ -262,12 +293,15 @@ class Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
-        SqlConnection* m_pAsyncConn;
+        // one DB connection per async worker, transactions are executed by the worker of their ordering key
+        SqlConnectionContainer m_pAsyncConnections;
+        SqlConnection* m_pAsyncConn;                        ///< First async connection, also used for direct execution
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
+        std::vector<SqlDelayThread*> m_threadBodies;        ///< Delay sql executers (owned by m_delayThreads)
+        std::vector<MaNGOS::Thread*> m_delayThreads;        ///< Executer threads, one per async connection
+        std::mutex m_barrierMutex;                          ///< Keeps barriers in the same order on every worker
+        bool m_barriersEnabled;                             ///< Cleared while the workers stop, guarded by m_barrierMutex
 
         std::atomic<bool> m_allowAsyncTransactions;         ///< flag which specifies if async transactions are enabled
 
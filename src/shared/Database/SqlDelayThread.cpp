@@ -20,7 +20,8 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase) :
+    m_dbEngine(db), m_dbConnection(conn), m_pingDatabase(pingDatabase), m_running(true), m_queueSize(0), m_maxLatency(0)
 {
 }
 
@@ -54,10 +55,19 @@ void SqlDelayThread::run()
         if ((loopCounter++) >= pingEveryLoop)
         {
             loopCounter = 0;
-            m_dbEngine->Ping();
+            if (m_pingDatabase)
+                m_dbEngine->Ping();
+            else
+            {
+                SqlConnection::Lock guard(m_dbConnection);
+                guard->Query("SELECT 1");
+            }
         }
     }
 
+    // requests queued before the stop, other workers may wait for barriers among them
+    ProcessRequests();
+
 #ifndef DO_POSTGRESQL
 #ifndef DO_SQLITE
     mysql_thread_end();
@@ -72,7 +82,7 @@ void SqlDelayThread::Stop()
 
 void SqlDelayThread::ProcessRequests()
 {
-    std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
+    std::queue<DelayedOperation> sqlQueue;
 
     // we need to move the contents of the queue to a local copy because executing these statements with the
     // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
@@ -83,8 +93,14 @@ void SqlDelayThread::ProcessRequests()
 
     while (!sqlQueue.empty())
     {
-        auto const s = std::move(sqlQueue.front());
+        auto const s = std::move(sqlQueue.front().first);
+        Clock::time_point const queued = sqlQueue.front().second;
         sqlQueue.pop();
         s->Execute(m_dbConnection);
+
+        uint32 const latency = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - queued).count());
+        if (latency > m_maxLatency)
+            m_maxLatency = latency;
+        --m_queueSize;
     }
 }
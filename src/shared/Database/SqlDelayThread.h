@@ -23,6 +23,7 @@
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -34,27 +35,38 @@ class SqlConnection;
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
+        typedef std::chrono::steady_clock Clock;
+        typedef std::pair<std::unique_ptr<SqlOperation>, Clock::time_point> DelayedOperation;
+
         std::mutex m_queueMutex;
-        std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
+        std::queue<DelayedOperation> m_sqlQueue;                ///< Queue of SQL statements and their enqueue time
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
+        bool const m_pingDatabase;                              ///< Ping all connections of the engine, not only ours
         std::atomic<bool> m_running;
+        std::atomic<uint32> m_queueSize;                        ///< Statements waiting or being executed
+        std::atomic<uint32> m_maxLatency;                       ///< Longest enqueue to completion time in ms since last reset
 
         // process all enqueued requests
         void ProcessRequests();
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase = true);
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql)
         {
             std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            m_sqlQueue.emplace(std::unique_ptr<SqlOperation>(sql), Clock::now());
+            ++m_queueSize;
             return true;
         }
 
+        uint32 GetQueueSize() const { return m_queueSize; }
+        ///< Return the longest statement latency seen since the previous call
+        uint32 ResetMaxLatency() { return m_maxLatency.exchange(0); }
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
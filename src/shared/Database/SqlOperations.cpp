@@ -76,6 +76,43 @@ SqlPreparedRequest::~SqlPreparedRequest()
     delete m_param;
 }
 
+void SqlBarrier::Arrive()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (--m_pending == 0)
+        m_condition.notify_all();
+
+    m_condition.wait(lock, [this] { return m_done; });
+}
+
+bool SqlBarrier::Execute(SqlOperation* sql, SqlConnection* conn)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_pending == 0; });
+    }
+
+    bool const result = sql->Execute(conn);
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_done = true;
+    }
+    m_condition.notify_all();
+    return result;
+}
+
+bool SqlBarrierWait::Execute(SqlConnection* /*conn*/)
+{
+    m_barrier->Arrive();
+    return true;
+}
+
+bool SqlBarrierRequest::Execute(SqlConnection* conn)
+{
+    return m_barrier->Execute(m_sql.get(), conn);
+}
+
 bool SqlPreparedRequest::Execute(SqlConnection* conn)
 {
     LOCK_DB_CONN(conn);
@@ -117,16 +154,15 @@ void SqlResultQueue::Add(MaNGOS::IQueryCallback* callback)
     m_queue.push(std::unique_ptr<MaNGOS::IQueryCallback>(callback));
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue)
 {
-    if (!callback || !thread || !queue)
+    if (!callback || !db || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
-    return true;
+    return db->DelayOperation(holderEx);
 }
 
 bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
@@ -26,6 +26,7 @@
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <condition_variable>
 
 /// ---- BASE ---
 
@@ -68,6 +69,48 @@ class SqlTransaction : public SqlOperation
         bool Execute(SqlConnection* conn) override;
 };
 
+/// ---- ORDERING BARRIER ----
+
+// Orders a request of the shared key against all async workers: the request runs once every other worker
+// finished what was queued before it, and those workers wait until it is done before going on
+class SqlBarrier
+{
+    public:
+        explicit SqlBarrier(uint32 workers) : m_pending(workers), m_done(false) {}
+
+        // called by the other workers
+        void Arrive();
+        // called by the worker of the request
+        bool Execute(SqlOperation* sql, SqlConnection* conn);
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        uint32 m_pending;
+        bool m_done;
+};
+
+class SqlBarrierWait : public SqlOperation
+{
+    public:
+        explicit SqlBarrierWait(std::shared_ptr<SqlBarrier> barrier) : m_barrier(std::move(barrier)) {}
+        bool Execute(SqlConnection* conn) override;
+
+    private:
+        std::shared_ptr<SqlBarrier> m_barrier;
+};
+
+class SqlBarrierRequest : public SqlOperation
+{
+    public:
+        SqlBarrierRequest(std::shared_ptr<SqlBarrier> barrier, SqlOperation* sql) : m_barrier(std::move(barrier)), m_sql(sql) {}
+        bool Execute(SqlConnection* conn) override;
+
+    private:
+        std::shared_ptr<SqlBarrier> m_barrier;
+        std::unique_ptr<SqlOperation> m_sql;
+};
+
 class SqlPreparedRequest : public SqlOperation
 {
     public:
@@ -130,7 +173,7 @@ class SqlQueryHolder
         void SetSize(size_t size);
         std::unique_ptr<QueryResult> GetResult(size_t index);
         void SetResult(size_t index, std::unique_ptr<QueryResult> queryResult);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        bool Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -19,34 +19,90 @@
 #ifndef MANGOS_MESSAGER_H
 #define MANGOS_MESSAGER_H
 
-#include <vector>
-#include <mutex>
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
+// Queue of callbacks which other threads post to the owner of T, executed by the owner in Execute
+// Producers push with a single CAS, the consumer takes the whole batch at once, so no lock is involved
+// Every message is one allocation holding the callable inline, callables only need to be movable
 template <class T>
 class Messager
 {
     public:
-        void AddMessage(const std::function<void(T*)>& message)
+        Messager() : m_head(nullptr), m_collisions(0) {}
+        ~Messager()
         {
-            std::lock_guard<std::mutex> guard(m_messageMutex);
-            m_messageVector.push_back(message);
+            Message* message = m_head.exchange(nullptr);
+            while (message)
+            {
+                std::unique_ptr<Message> current(message);
+                message = message->next;
+            }
         }
+
+        Messager(const Messager&) = delete;
+        Messager& operator=(const Messager&) = delete;
+
+        template <class F>
+        void AddMessage(F&& message)
+        {
+            Message* node = new MessageImpl<typename std::decay<F>::type>(std::forward<F>(message));
+            node->next = m_head.load(std::memory_order_relaxed);
+            while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+                m_collisions.fetch_add(1, std::memory_order_relaxed);
+        }
+
         void Execute(T* object)
         {
-            std::vector<std::function<void(T*)>> messageVectorCopy;
+            Message* message = m_head.exchange(nullptr, std::memory_order_acquire);
+
+            // the list is in reverse posting order, restore it so messages run in the order they were added
+            Message* ordered = nullptr;
+            while (message)
             {
-                std::lock_guard<std::mutex> guard(m_messageMutex);
-                std::swap(m_messageVector, messageVectorCopy);
+                Message* next = message->next;
+                message->next = ordered;
+                ordered = message;
+                message = next;
             }
-            for (auto& message : messageVectorCopy)
-                message(object);
 
-            messageVectorCopy.clear();
+            // messages added while executing are left for the next call
+            while (ordered)
+            {
+                std::unique_ptr<Message> current(ordered);
+                ordered = ordered->next;
+                current->Execute(object);
+            }
         }
+
+        // number of times producers had to retry because another thread posted at the same time
+        size_t ResetCollisionCount() { return m_collisions.exchange(0, std::memory_order_relaxed); }
+
     private:
-        std::vector<std::function<void(T*)>> m_messageVector;
-        std::mutex m_messageMutex;  
+        struct Message
+        {
+            Message() : next(nullptr) {}
+            virtual ~Message() {}
+            virtual void Execute(T* object) = 0;
+
+            Message* next;
+        };
+
+        template <class F>
+        struct MessageImpl : public Message
+        {
+            template <class Arg>
+            explicit MessageImpl(Arg&& func) : m_func(std::forward<Arg>(func)) {}
+            void Execute(T* object) override { m_func(object); }
+
+            F m_func;
+        };
+
+        std::atomic<Message*> m_head;
+        std::atomic<size_t> m_collisions;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -52,8 +52,8 @@ namespace MaNGOS
             return false;
         }
 
-        m_outBuffer.reset(new PacketBuffer);
-        m_secondaryOutBuffer.reset(new PacketBuffer);
+        m_outBuffer.reset(new OutgoingData);
+        m_secondaryOutBuffer.reset(new OutgoingData);
         m_inBuffer.reset(new PacketBuffer);
 
         StartAsyncRead();
@@ -168,18 +168,55 @@ namespace MaNGOS
         return true;
     }
 
+    void Socket::OutgoingData::Clear()
+    {
+        buffer.m_writePosition = 0;
+        headers.clear();
+        sharedContent.clear();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    Socket::OutgoingData* Socket::GetWriteBuffer()
+    {
+        // get the correct buffer depending on the current writing state
+        return m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+    }
+
     void Socket::Write(const char* header, int headerSize, const char* content, int contentSize)
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        OutgoingData* outBuffer = GetWriteBuffer();
 
         // write the header
-        outBuffer->Write(header, headerSize);
+        outBuffer->headers.emplace_back(outBuffer->buffer.m_writePosition, headerSize);
+        outBuffer->buffer.Write(header, headerSize);
 
         // write the content
-        outBuffer->Write(content, contentSize);
+        if (contentSize > 0)
+            outBuffer->buffer.Write(content, contentSize);
+
+        // flush data if need
+        if (m_writeState == WriteState::Idle)
+            StartWriteFlushTimer();
+    }
+
+    void Socket::Write(const char* header, int headerSize, SharedContent const& content)
+    {
+        if (content.size < SharedContentMinSize)
+        {
+            Write(header, headerSize, reinterpret_cast<const char*>(content.data), int(content.size));
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        OutgoingData* outBuffer = GetWriteBuffer();
+
+        // write the header, the content is only referenced and follows it in the send sequence
+        outBuffer->headers.emplace_back(outBuffer->buffer.m_writePosition, headerSize);
+        outBuffer->buffer.Write(header, headerSize);
+        outBuffer->sharedContent.emplace_back(outBuffer->buffer.m_writePosition, content);
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
@@ -190,11 +227,9 @@ namespace MaNGOS
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        OutgoingData* outBuffer = GetWriteBuffer();
 
-        // write the header
-        outBuffer->Write(buffer, length);
+        outBuffer->buffer.Write(buffer, length);
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
@@ -237,9 +272,34 @@ namespace MaNGOS
         // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
         m_writeState = WriteState::Sending;
 
+        StartAsyncWrite();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::StartAsyncWrite()
+    {
+        OutgoingData& outBuffer = *m_outBuffer;
+
+        // all headers of this send are prepared in one go, in the order they were written
+        for (auto const& header : outBuffer.headers)
+            PrepareOutgoingHeader(&outBuffer.buffer.m_buffer[header.first], header.second);
+
+        // copied data is sent straight from the buffer, shared content is spliced in where it was written
+        m_sendBuffers.clear();
+        size_t position = 0;
+        for (auto const& content : outBuffer.sharedContent)
+        {
+            if (content.first > position)
+                m_sendBuffers.emplace_back(&outBuffer.buffer.m_buffer[position], content.first - position);
+            m_sendBuffers.emplace_back(content.second.data, content.second.size);
+            position = content.first;
+        }
+        if (outBuffer.buffer.m_writePosition > position)
+            m_sendBuffers.emplace_back(&outBuffer.buffer.m_buffer[position], outBuffer.buffer.m_writePosition - position);
+
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                  make_custom_alloc_handler(m_allocator,
+        boost::asio::async_write(m_socket, m_sendBuffers,
+                                 make_custom_alloc_handler(m_allocator,
         [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
     }
 
@@ -251,7 +311,7 @@ namespace MaNGOS
         m_outBufferFlushTimer.cancel();
     }
 
-    void Socket::OnWriteComplete(const boost::system::error_code& error, size_t length)
+    void Socket::OnWriteComplete(const boost::system::error_code& error, size_t /*length*/)
     {
         // we must check this before locking the mutex because the connection will be closed,
         // which leads to a locked mutex being destroyed.  not good!
@@ -270,37 +330,16 @@ namespace MaNGOS
         std::lock_guard<std::mutex> guard(m_mutex);
 
         assert(m_writeState == WriteState::Sending);
-        assert(length <= m_outBuffer->m_writePosition);
-
-        // if there is data left to write, move it to the start of the buffer
-        if (length < m_outBuffer->m_writePosition)
-        {
-            memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-            m_outBuffer->m_writePosition -= length;
-        }
-        // if not, reset the write pointer
-        else
-            m_outBuffer->m_writePosition = 0;
 
-        // if there is data in the secondary buffer, append it to the primary buffer
-        if (m_secondaryOutBuffer->m_writePosition > 0)
-        {
-            // do we have enough space? if not, resize
-            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
+        // async_write only completes without error once everything was sent, the shared content can be released
+        m_outBuffer->Clear();
 
-            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
+        // data written during the send is waiting in the secondary buffer, send it next
+        std::swap(m_outBuffer, m_secondaryOutBuffer);
 
-            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-            m_secondaryOutBuffer->m_writePosition = 0;
-        }
-
-        std::shared_ptr<Socket> ptr = shared<Socket>();
         // if there is any data to write, do so immediately
-        if (m_outBuffer->m_writePosition > 0)
-            m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                      make_custom_alloc_handler(m_allocator,
-            [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length);}));
+        if (!m_outBuffer->Empty())
+            StartAsyncWrite();
         else
             m_writeState = WriteState::Idle;
     }
@@ -29,12 +29,27 @@
 #include <string>
 #include <mutex>
 #include <functional>
+#include <utility>
+#include <vector>
 
 namespace MaNGOS
 {
     class Socket : public std::enable_shared_from_this<Socket>
     {
+        public:
+            // content which stays alive and unchanged until it was sent, so it can be sent without copying it
+            struct SharedContent
+            {
+                uint8 const* data;
+                size_t size;
+                std::shared_ptr<void const> owner;
+            };
+
+            // content smaller than this is copied into the send buffer, it is cheaper than another buffer in the send sequence
+            static const size_t SharedContentMinSize = 128;
+
         private:
+
             // buffer timeout period, in milliseconds.  higher values decrease responsiveness
             // ingame but increase bandwidth efficiency by reducing tcp overhead.
             static const int BufferTimeout = 50;
@@ -59,9 +74,22 @@ namespace MaNGOS
 
             std::function<void(Socket *)> m_closeHandler;
 
+            // outgoing data waiting for one send operation. small writes are copied into the buffer,
+            // shared content is only referenced and spliced into the buffer sequence at its position
+            struct OutgoingData
+            {
+                PacketBuffer buffer;
+                std::vector<std::pair<size_t, size_t>> headers;     // position and length of headers to prepare before sending
+                std::vector<std::pair<size_t, SharedContent>> sharedContent;
+
+                bool Empty() const { return buffer.m_writePosition == 0 && sharedContent.empty(); }
+                void Clear();
+            };
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
-            std::unique_ptr<PacketBuffer> m_outBuffer;
-            std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
+            std::unique_ptr<OutgoingData> m_outBuffer;
+            std::unique_ptr<OutgoingData> m_secondaryOutBuffer;
+            std::vector<boost::asio::const_buffer> m_sendBuffers;
 
             std::mutex m_mutex;
             std::mutex m_closeMutex;
@@ -71,8 +99,10 @@ namespace MaNGOS
             void OnRead(const boost::system::error_code &error, size_t length);
 
             void StartWriteFlushTimer();
+            void StartAsyncWrite();
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
+            OutgoingData* GetWriteBuffer();
 
             void OnError(const boost::system::error_code &error);
 
@@ -90,6 +120,10 @@ namespace MaNGOS
 
             void ForceFlushOut();
 
+            // called on the network thread for every header queued together with content, in the order they were written,
+            // right before the header is sent. allows stream ciphers to run in send order without locking at the caller
+            virtual void PrepareOutgoingHeader(uint8* /*header*/, size_t /*length*/) {}
+
         public:
             Socket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler);
             virtual ~Socket() = default;
@@ -105,6 +139,7 @@ namespace MaNGOS
 
             void Write(const char *buffer, int length);
             void Write(const char *header, int headerSize, const char* content, int contentSize);
+            void Write(const char *header, int headerSize, SharedContent const& content);
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 